@@ -4,14 +4,18 @@
 ////////////////////////////////////////////////////////////////////////////////
 // Functions exported from PixelVFO.ino
 ////////////////////////////////////////////////////////////////////////////////
-#include <Adafruit_ILI9341.h>
+#include "panel.h"
 #include <Fonts/FreeSansBold12pt7b.h>
 #include <Fonts/FreeSansBold18pt7b.h>
 #include <Fonts/FreeSansBold24pt7b.h>
 #include <Fonts/FreeSansBold9pt7b.h>
+#include "mirror.h"
+#include "latency.h"
 
-// macros to enable tailoring of debug calls
-#define DEBUG     debug
+#include "log.h"
+
+// macros to enable tailoring of debug calls, see log.h
+#define DEBUG     LOG_DEBUG
 
 // macro to get number of elements in an array
 #define ALEN(a)    (sizeof(a)/sizeof((a)[0]))
@@ -19,6 +23,9 @@
 typedef unsigned long Frequency;
 typedef int SelOffset;
 
+// highest frequency that fits the display
+#define VFO_MAX_FREQ          99999999L
+
 // constants for main screen layout
 #define NUM_F_CHAR            8     // number digits in frequency display
 #define CHAR_WIDTH            27    // width of each frequency digit
@@ -51,25 +58,64 @@ typedef int SelOffset;
 
 #define FONT_DIALOG           (&FreeSansBold9pt7b)  // font for dialog message text
 
-extern Adafruit_ILI9341 tft;
+// the VFO states
+enum VFOState
+{
+  VFO_Standby,
+  VFO_Online
+};
+
+// a VFO register, everything needed to put a VFO on air and display it
+struct VFORegister
+{
+  Frequency freq;               // register frequency
+  SelOffset digit;              // selected digit
+  uint32_t word;                // DDS tuning word for 'freq'
+  char display[NUM_F_CHAR];     // frequency display digits for 'freq'
+};
+
+// indices of the two VFO registers
+#define VFO_A       0
+#define VFO_B       1
+
+extern PanelTFT tft;
 
 extern Frequency frequency;                            // frequency as a long integer
 extern SelOffset freq_digit_select;                    // index of selected digit in frequency display
+extern char freq_display[NUM_F_CHAR];                  // digits of frequency, as char values ['0'-'9']
+extern VFOState vfo_state;                             // ONLINE or standby
+extern VFORegister vfo_reg[2];                         // the A and B VFO registers
+extern int vfo_active;                                 // index of the active register
+extern bool vfo_split;                                 // 'true' if in split mode
 
 // the abort() function exported from the top-level code
 void abort(const char *msg);
+void abort_draw(const char *msg);
+
+bool pen_touch(int *, int *, LatencyScreen);
+
+// set the DDS to match the current VFO state
+void vfo_retune(void);
+void vfo_select(int reg);
+void vfo_set_freq(int reg, Frequency freq);
+void drawABButton(void);
+void drawOnline(void);
+void draw_screen(void);
+void keypad_draw(int offset);
+void credits_draw(void);
 
-bool pen_touch(int *, int *);
+// frequency display routines
+void freq_show(int select=-1);
+void freq_update(const char *display);
+void freq_to_buff(char *buff, unsigned long freq);
 
 // the debug routines - writes to Serial output
-void debug(const char *format, ...);
-void debug_ignore(const char *format, ...);
-void dump_mem(const char *msg);
 #ifdef DEBUGHEX
 void dumphex(const char *msg, void *base, int num);
 #endif
 
-extern int ts_width;
-extern int ts_height;
+// screen size, fixed by the panel type
+constexpr int ts_width = SCREEN_WIDTH;
+constexpr int ts_height = SCREEN_HEIGHT;
 
 #endif
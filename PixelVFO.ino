@@ -4,13 +4,11 @@
  * VK4FAWR - rzzzwilson@gmail.com
  ****************************************************/
 
-#include <malloc.h>
 #include <stdlib.h>
 
 #include <stdio.h>
 #include <stdarg.h>
 #include <SPI.h>
-#include <Adafruit_ILI9341.h>
 #include <XPT2046_Touchscreen.h>
 #include "PixelVFO.h"
 #include "hotspot.h"
@@ -18,14 +16,29 @@
 #include "actions.h"
 #include "eeprom.h"
 #include "utils.h"
+#include "dds.h"
+#include "scan.h"
+#include "calibrate.h"
+#include "bandplan.h"
+#include "cat.h"
+#include "mirror.h"
+#include "profile.h"
+#include "memory.h"
+#include "idle.h"
+#include "boot.h"
+#include "text.h"
+#include "fill.h"
+#include "encoder.h"
+#include "spibus.h"
+#include "overlay.h"
+#include "render.h"
+#include "snapshot.h"
+#include "console.h"
 
 #define MAJOR_VERSION   "0"
 #define MINOR_VERSION   "6"
 #define CALLSIGN        "vk4fawr"
 
-#define SCREEN_WIDTH    320
-#define SCREEN_HEIGHT   240
-
 #define TOUCH_THRESHOLD 100
 
 #define USE_BIG_SCREEN  1
@@ -46,20 +59,19 @@
 #endif
 
 // The XPT2046 uses hardware SPI, #4 is CS with #3 for interrupts
-// We don't use the T_IRQ pin as we want to use interrupts in VFO code
-// TODO: There is some problem with T_IRQ interrupt.  They just stop
-//       working on small code changes and removing/reapplying power
-//       sometimes fixes the problem!?  Think about using polling in
-//       loop() instead of interrupts.
+// The T_IRQ interrupts just stop working on small code changes, so the
+// library doesn't get the pin.  The idle code reads it as a level and
+// only uses the interrupt to wake the CPU early.
 #define TS_CS       4
 #define TS_IRQ      3
-XPT2046_Touchscreen ts(TS_CS, TS_IRQ);
+#define TS_SAMPLE_MS    10      // touch sample period while drawing
+XPT2046_Touchscreen ts(TS_CS);
 
 // The display also uses hardware SPI, plus #9 & #10
 #define TFT_RST     8
 #define TFT_DC      9
 #define TFT_CS      10
-Adafruit_ILI9341 tft = Adafruit_ILI9341(TFT_CS, TFT_DC, TFT_RST);  
+PanelTFT tft = PanelTFT(TFT_CS, TFT_DC, TFT_RST);
 
 // display constants - offsets, colours, etc
 #define FONT_FREQ           (&FreeSansBold24pt7b) // font for frequency display
@@ -79,6 +91,21 @@ Adafruit_ILI9341 tft = Adafruit_ILI9341(TFT_CS, TFT_DC, TFT_RST);
 #define MENUBTN_BG2            0x4000
 #define MENUBTN_FG             ILI9341_BLUE
 
+// scan screen status line
+#define SCAN_STATUS_Y          110
+#define SCAN_STATUS_H          35
+#define SCAN_FG                ILI9341_WHITE
+
+// A/B button definitions
+#define ABBTN_WIDTH            90
+#define ABBTN_HEIGHT           35
+#define ABBTN_X                ((ts_width - ABBTN_WIDTH) / 2)
+#define ABBTN_Y                (ts_height - ABBTN_HEIGHT)
+#define ABBTN_BG               ILI9341_CYAN
+#define ABBTN_BG2              0x4000
+#define ABBTN_SPLIT_BG         ILI9341_YELLOW
+#define ABBTN_FG               ILI9341_BLACK
+
 #define CREDIT_FG              ILI9341_BLACK
 #define CREDIT_BG              ILI9341_GREEN
 
@@ -94,20 +121,25 @@ Adafruit_ILI9341 tft = Adafruit_ILI9341(TFT_CS, TFT_DC, TFT_RST);
 #define ONLINE_FG           ILI9341_GREEN
 #define STANDBY_FG          ILI9341_BLACK
 
+// defined below and used before their definitions, so the sketch also
+// builds without the Arduino IDE's generated prototypes (tests/)
+void undrawOnline(void);
+bool freq_hs_handler(HotSpot *hs);
+bool ab_hs_handler(HotSpot *hs_ptr);
+bool online_hs_handler(HotSpot *hs_ptr);
+bool menu_hs_handler(HotSpot *hs_ptr);
+bool keypad_show(int offset);
+
 // pen state
 static bool pen_down = false;  // pen up/down
 
-// the VFO states
-enum VFOState
-{
-  VFO_Standby,
-  VFO_Online
-};
+// a new touch read by touch_sample() and not yet returned by pen_touch()
+static bool touch_latched = false;
+static TS_Point touch_point;       // raw touch position
+static unsigned long touch_time;   // micros() when the touch was read
 
 // touchscreen stuff
 //int ts_rotation = 0;
-int ts_width = SCREEN_WIDTH;
-int ts_height = SCREEN_HEIGHT;
 
 // state variables for frequency - display, etc
 // the characters in 'freq_display' are stored MSB at left (index 0)
@@ -121,60 +153,13 @@ uint32_t msraw = 0x80000000;
 
 VFOState vfo_state = VFO_Standby;
 
+// the two VFO registers
+// 'frequency', 'freq_digit_select' and 'freq_display' are the working copy
+// of the active register, which is saved back when the registers are swapped
+VFORegister vfo_reg[2];
+int vfo_active = VFO_A;
+bool vfo_split = false;
 
-//-----------------------------------------------
-// Debug routine - Dump some memory usage information.
-//-----------------------------------------------
-
-extern "C" char *sbrk(int i);
-
-int32_t unallocated(void)
-{
-  char tos;
-  return &tos - (char*) sbrk(0);
-}
-
-void dump_mem(const char *msg)
-{
-  char *heapend = sbrk(0);
-  register char *stack_ptr asm ("sp");
-  int32_t freemem = unallocated();
-  
-  Serial.printf("@@@@@ %s: heapend=%08x, stack_ptr=%08x, free=%d\n",
-                msg, heapend, stack_ptr, freemem);
-}
-
-//-----------------------------------------------
-// Debug routine - IGNORE THE CALL
-//     format  the printf-style format string
-//     ...     the args to 'format'
-//
-// This routine does nothing.
-//-----------------------------------------------
-
-void debug_ignore(const char *format, ...)
-{
-}
-
-//-----------------------------------------------
-// Debug routine - print debug sring to Serial.printf.
-//     format  the printf-style format string
-//     ...     the args to 'format'
-//
-// There is a limit of 512 bytes to the resultant string.
-//-----------------------------------------------
-
-void debug(const char *format, ...)
-{
-  static char buff[256];
-  va_list aptr;
-
-  va_start(aptr, format);
-  vsprintf(buff, format, aptr);
-  va_end(aptr);
-
-  Serial.printf(buff);
-}
 
 #ifdef DEBUGHEX
 //-----------------------------------------------
@@ -189,19 +174,19 @@ void dumphex_helper(char *base, int num)
 
   memset(ascii, 0, sizeof(ascii));
 
-  Serial.printf("%08x  ", base);
+  console.printf("%08x  ", base);
   
   for (int i = 0; i < 16; ++i)
   {
     char ch = *(base + i);
     
-    Serial.printf(F("%02x "), ch);
+    console.printf(F("%02x "), ch);
     if (isprint(ch))
       *(ascii + i) = ch;
     else
       *(ascii + i) = '.';
   }
-  Serial.printf(F("  %s\n"), ascii);
+  console.printf(F("  %s\n"), ascii);
 }
 
 //-----------------------------------------------
@@ -215,15 +200,15 @@ void dumphex(const char *msg, void *base, int num)
 {
   char *off = (char *) base;
 
-  Serial.printf(F("~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n"), msg);
-  Serial.printf(F("HexDump: %s\n"), msg);
+  console.printf(F("~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n"), msg);
+  console.printf(F("HexDump: %s\n"), msg);
   while (num > 0)
   {
     dumphex_helper(off, 16);
     num -= 16;
     off += 16;
   }
-  Serial.printf(F("~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n"), msg);
+  console.printf(F("~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n"), msg);
 }
 #endif
 
@@ -234,50 +219,31 @@ void dumphex(const char *msg, void *base, int num)
 
 void abort(const char *msg)
 {
-  char *mptr = (char *) msg;
-  int  offset_y = 30;
-  
-  // first, send error message to console
-  Serial.printf(F("*********************************************************\n"));
-  Serial.printf(F("* %s\n"), msg);
-  Serial.printf(F("*********************************************************\n"));
+  // first, send any log history and the error message to console
+  log_flush();
+  console.printf(F("*********************************************************\n"));
+  console.printf(F("* %s\n"), msg);
+  console.printf(F("*********************************************************\n"));
+  console.flush();
 
   // write message to the TFT screen
-  tft.setFont(FONT_ABORT);
-  tft.fillRect(0, 0, tft.width(), tft.height(), ABORT_BG);
-  tft.setTextColor(ABORT_FG);
-  tft.setCursor(5, offset_y);
+  abort_draw(msg);
 
-  while (msg)
-  {
-    int16_t x1;
-    int16_t y1;
-    uint16_t w;
-    uint16_t h;
+  // wait here, forever, still sending the mirror stream
+  while (1)
+    console_drain();
+}
 
-    mptr = (char *) msg;
-    while (*mptr)
-    {
-      tft.getTextBounds(mptr, 0, 0, &x1, &y1, &w, &h);
-      if (w > tft.width())
-      {
-        char save;
-        save = *mptr;
-        *mptr = '\0';
-        tft.print(msg);
-        offset_y += 30;
-        tft.setCursor(5, offset_y);
-        *mptr = save;
-        msg = mptr;
-      }
-      ++mptr;
-    }
-    
-    tft.print(msg);
-  }
+//-----------------------------------------------
+// Draw the abort screen.
+//     msg  the message to show
+//-----------------------------------------------
 
-  // wait here, forever
-  while (1);
+void abort_draw(const char *msg)
+{
+  tft.fillRect(0, 0, tft.width(), tft.height(), ABORT_BG);
+  tft.setTextColor(ABORT_FG);
+  text_draw_wrapped(FONT_ABORT, msg, 5, 30, tft.width() - 10, 0);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -291,8 +257,9 @@ void abort(const char *msg)
 // Updates all digits on the screen.  Skips leading zeros.
 //-----------------------------------------------
 
-void freq_show(int select=-1)
+void freq_show(int select)
 {
+  PROFILE_ZONE(PZ_FreqShow);
   bool leading_space = true;
 
   tft.setFont(FONT_FREQ);
@@ -312,6 +279,39 @@ void freq_show(int select=-1)
   }
 }
 
+//-----------------------------------------------
+// Change the frequency display to show new digits.
+//     display  address of the new digits, MSB first
+//
+// Only digits that look different are redrawn, including those
+// that change between a leading blank and a zero.
+//-----------------------------------------------
+
+void freq_update(const char *display)
+{
+  bool old_leading = true;
+  bool new_leading = true;
+
+  tft.setFont(FONT_FREQ);
+
+  for (int i = 0; i < NUM_F_CHAR; ++i)
+  {
+    bool old_blank = old_leading && (freq_display[i] == '0');
+    bool new_blank = new_leading && (display[i] == '0');
+
+    old_leading = old_blank;
+    new_leading = new_blank;
+
+    if ((display[i] != freq_display[i]) || (old_blank != new_blank))
+    {
+      freq_display[i] = display[i];
+      tft.fillRect(freq_char_x_offset[i], 2, CHAR_WIDTH, DEPTH_FREQ_DISPLAY-4, FREQ_BG);
+      if (!new_blank)
+        tft.drawChar(freq_char_x_offset[i], TOP_BAR_Y, display[i], FREQ_FG, FREQ_BG, 1);
+    }
+  }
+}
+
 //-----------------------------------------------
 // Unselect a digit in the frequency display.
 //     select  index of digit to unselect
@@ -384,7 +384,7 @@ void draw_thousands(void)
 
 void display_flash(void)
 {
-  Serial.printf(F("display_flash: called\n"));
+  console.printf(F("display_flash: called\n"));
 }
 
 bool hs_creditsback_handler(HotSpot *hs)
@@ -400,9 +400,12 @@ static HotSpot hs_credits[] =
 
 #define CreditsHSLen   ALEN(hs_credits)
 
-bool credits_action(void *ignore)
+//-----------------------------------------------
+// Draw the credits screen.
+//-----------------------------------------------
+
+void credits_draw(void)
 {
-  // draw the credits screen
   tft.fillRect(0, 0, tft.width(), tft.height(), CREDIT_BG);
   tft.fillRoundRect(0, 0, tft.width(), DEPTH_FREQ_DISPLAY, 5, FREQ_BG);
   tft.setTextColor(CREDIT_FG);
@@ -417,17 +420,23 @@ bool credits_action(void *ignore)
   tft.setFont(FONT_CREDIT2);
   tft.setCursor(180, 230);
   tft.printf("%s", CALLSIGN);
-  
+}
+
+bool credits_action(int ignore)
+{
+  credits_draw();
+
   // event loop
   while (true)
   {
     int x;    // pen touch coordinates
     int y;
   
-    if (pen_touch(&x, &y))
+    if (pen_touch(&x, &y, LAT_Dialog))
     {
       if (HotSpot *hs = hs_touched(x, y, hs_credits, CreditsHSLen))
       {
+        hs_press(hs);
         (*hs->handler)(hs);
         DEBUG("credits_action: hs_touched() called, returning 'true'\n");
         return true;
@@ -436,39 +445,163 @@ bool credits_action(void *ignore)
   }
 }
 
+//-----------------------------------------------
+// The slot scan screen.
+// Touching the screen body pauses/resumes the scan, "Stop" ends it.
+//-----------------------------------------------
+
+bool scan_stop_handler(HotSpot *hs)
+{
+  DEBUG("scan_stop_handler: called\n");
+  return true;
+}
+
+bool scan_pause_handler(HotSpot *hs)
+{
+  if (scan_paused())
+    scan_resume();
+  else
+    scan_pause();
+  return false;
+}
+
+static HotSpot hs_scan[] =
+{
+  {MENUBTN_X, MENUBTN_Y, MENUBTN_WIDTH, MENUBTN_HEIGHT, scan_stop_handler, 0},
+  {0, DEPTH_FREQ_DISPLAY, ts_width, ts_height-DEPTH_FREQ_DISPLAY, scan_pause_handler, 1},
+};
+
+#define ScanHSLen   ALEN(hs_scan)
+
+void scan_status(void)
+{
+  const ScanChannel *chan = scan_channel();
+
+  tft.fillRect(0, SCAN_STATUS_Y, tft.width(), SCAN_STATUS_H, SCREEN_BG2);
+  tft.setFont(FONT_MENUITEM);
+  tft.setTextColor(SCAN_FG);
+  tft.setCursor(10, SCAN_STATUS_Y + SCAN_STATUS_H - 10);
+  tft.printf("Slot %d  %s", chan->slot, (scan_paused()) ? "Paused" : "Scanning");
+}
+
+bool scan_action(int ignore)
+{
+  if (!scan_begin())
+  {
+    util_alert("No saved slots to scan.");
+    return false;   // menu restored under the alert
+  }
+
+  // draw the scan screen, the frequency bar is filled in by freq_update()
+  draw_screen();
+  draw_thousands();
+  undrawOnline();
+  util_button("Stop", MENUBTN_X, MENUBTN_Y, MENUBTN_WIDTH, MENUBTN_HEIGHT,
+              MENUBTN_BG2, MENUBTN_BG, MENUBTN_BG2);
+  overlay_screen(NULL, 0);
+  memset(freq_display, '0', sizeof(freq_display));
+  
+  // event loop
+  while (true)
+  {
+    int x;    // pen touch coordinates
+    int y;
+
+    if (scan_poll())
+    {
+      freq_update(scan_channel()->display);
+      scan_status();
+    }
+  
+    if (pen_touch(&x, &y, LAT_Dialog))
+    {
+      if (HotSpot *hs = hs_touched(x, y, hs_scan, ScanHSLen))
+      {
+        (*hs->handler)(hs);
+        if (hs->arg == 0)
+          break;
+        scan_status();
+      }
+    }
+  }
+
+  scan_end();
+  freq_to_buff(freq_display, frequency);
+  vfo_retune();
+  DEBUG("scan_action: returning 'true'\n");
+  return true;
+}
+
 //-----------------------------------------------
 // Define the PixelVFO menu system
 //-----------------------------------------------
 
-struct MenuItem mi_reset_no = {"No", NULL, &action_no_reset, NULL};
-struct MenuItem mi_reset_yes = {"Yes", NULL, &action_reset, NULL};
-struct MenuItem *mia_reset[] = {&mi_reset_no, &mi_reset_yes};
-struct Menu reset_menu = {"Reset all", 0, ALEN(mia_reset), mia_reset, false};          
+constexpr MenuItem mia_reset[] =
+{
+  {"No", NULL, &action_no_reset, 0},
+  {"Yes", NULL, &action_reset, 0},
+};
+constexpr Menu reset_menu = {"Reset all", ALEN(mia_reset), mia_reset, false};
+static_assert(menu_valid(&reset_menu), "bad reset menu");
 
-struct MenuItem mi_brightness = {"Brightness", NULL, &action_brightness, NULL};
-struct MenuItem mi_calibrate = {"Calibrate", NULL, &action_calibrate, NULL};
-struct MenuItem *mia_settings[] = {&mi_brightness, &mi_calibrate};
-struct Menu settings_menu = {"Settings", 0, ALEN(mia_settings), mia_settings, false};
+constexpr MenuItem mia_settings[] =
+{
+  {"Brightness", NULL, &action_brightness, 0},
+  {"Calibrate", NULL, &action_calibrate, 0},
+  {"Split", NULL, &action_split, 0},
+  {"Memory", NULL, &action_memory, 0},
+#ifdef PROFILE_ENABLE
+  {"Profile", NULL, &action_profile, 0},
+#endif
+};
+constexpr Menu settings_menu = {"Settings", ALEN(mia_settings), mia_settings, false};
+static_assert(menu_valid(&settings_menu), "bad settings menu");
 
-struct MenuItem mi_saveslot = {"Save slot", NULL, &action_slot_save, NULL};
-struct MenuItem mi_restoreslot = {"Restore slot", NULL, &action_slot_restore, NULL};
-struct MenuItem mi_deleteslot = {"Delete slot", NULL, &action_slot_delete, NULL};
-struct MenuItem *mia_slots[] = {&mi_saveslot, &mi_restoreslot, &mi_deleteslot};
-struct Menu slots_menu = {"Slots", 0, ALEN(mia_slots), mia_slots, false};
+constexpr MenuItem mia_slots[] =
+{
+  {"Save slot", NULL, &action_slot_save, 0},
+  {"Restore slot", NULL, &action_slot_restore, 0},
+  {"Delete slot", NULL, &action_slot_delete, 0},
+};
+constexpr Menu slots_menu = {"Slots", ALEN(mia_slots), mia_slots, false};
+static_assert(menu_valid(&slots_menu), "bad slots menu");
+
+constexpr MenuItem mia_sweep[] =
+{
+  {"Run sweep", NULL, &action_sweep_run, 0},
+  {"Set start", NULL, &action_sweep_setstart, 0},
+  {"Set stop", NULL, &action_sweep_setstop, 0},
+  {"Step", &menu_sweep_step, NULL, 0},
+  {"Dwell", &menu_sweep_dwell, NULL, 0},
+};
+constexpr Menu sweep_menu = {"Sweep", ALEN(mia_sweep), mia_sweep, false};
+static_assert(menu_valid(&sweep_menu), "bad sweep menu");
 
-struct MenuItem mi_slots = {"Slots", &slots_menu, NULL, NULL};
-struct MenuItem mi_settings = {"Settings", &settings_menu, NULL, NULL};
-struct MenuItem mi_reset = {"Reset all", &reset_menu, NULL, NULL};
-struct MenuItem mi_credits = {"Credits", NULL, &credits_action, NULL};
+constexpr MenuItem mia_scan[] =
+{
+  {"Start scan", NULL, &scan_action, 0},
+  {"Dwell", &menu_scan_dwell, NULL, 0},
+};
+constexpr Menu scan_menu = {"Scan", ALEN(mia_scan), mia_scan, false};
+static_assert(menu_valid(&scan_menu), "bad scan menu");
+
+constexpr MenuItem mia_main[] =
+{
+  {"Slots", &slots_menu, NULL, 0},
+  {"Scan", &scan_menu, NULL, 0},
+  {"Sweep", &sweep_menu, NULL, 0},
+  {"Monitor", NULL, &action_monitor, 0},
+  {"Settings", &settings_menu, NULL, 0},
+  {"Reset all", &reset_menu, NULL, 0},
+  {"Credits", NULL, &credits_action, 0},
 #if 1
-struct MenuItem mi_credits2 = {"Credits2", NULL, &credits_action, NULL};
-struct MenuItem mi_credits3 = {"Credits3", NULL, &credits_action, NULL};
-struct MenuItem mi_credits4 = {"Credits4", NULL, &credits_action, NULL};
-struct MenuItem *mia_main[] = {&mi_slots, &mi_settings, &mi_reset, &mi_credits, &mi_credits2, &mi_credits3, &mi_credits4};
-#else
-struct MenuItem *mia_main[] = {&mi_slots, &mi_settings, &mi_reset, &mi_credits};
+  {"Credits2", NULL, &credits_action, 0},
+  {"Credits3", NULL, &credits_action, 0},
+  {"Credits4", NULL, &credits_action, 0},
 #endif
-struct Menu menu_main = {"Menu", 0, ALEN(mia_main), mia_main, false};
+};
+constexpr Menu menu_main = {"Menu", ALEN(mia_main), mia_main, false};
+static_assert(menu_valid(&menu_main), "bad main menu");
 
 //////////////////////////////////////////////////////////////////////////////
 // Code to handle the 'online' and 'menu' buttons.
@@ -513,56 +646,175 @@ void undrawMenuButton(void)
   tft.fillRect(MENUBTN_X, MENUBTN_Y, MENUBTN_WIDTH, MENUBTN_HEIGHT, SCREEN_BG2);
 }
 
+//-----------------------------------------------
+// Draw and undraw the A/B button.
+// Shows the active register, different colour if split.
+//-----------------------------------------------
+
+void drawABButton(void)
+{
+  util_button((vfo_active == VFO_A) ? "VFO A" : "VFO B",
+              ABBTN_X, ABBTN_Y, ABBTN_WIDTH, ABBTN_HEIGHT,
+              ABBTN_BG2, (vfo_split) ? ABBTN_SPLIT_BG : ABBTN_BG, ABBTN_FG);
+}
+
+void undrawABButton(void)
+{
+  tft.fillRect(ABBTN_X, ABBTN_Y, ABBTN_WIDTH, ABBTN_HEIGHT, SCREEN_BG2);
+}
+
+//-----------------------------------------------
+// Draw the frequency units label.
+//-----------------------------------------------
+
+void draw_hz(void)
+{
+  tft.setFont(FONT_FREQ);
+  tft.setCursor(MHZ_OFFSET_X, TOP_BAR_Y);
+  tft.setTextColor(FREQ_FG);
+  tft.print("Hz");
+}
+
+// the widgets of the main screen that draw themselves
+enum MainWidget
+{
+  MW_Freq,      // frequency digits and thousands markers
+  MW_Hz,        // frequency units label
+  MW_Band,      // band indicator
+  MW_Online,    // ONLINE/standby button
+  MW_AB,        // A/B button
+  MW_Menu,      // Menu button
+};
+
+//-----------------------------------------------
+// Redraw one widget of the main screen, for overlay_close().
+//     arg  the MainWidget to draw
+//-----------------------------------------------
+
+static void main_widget_draw(int arg)
+{
+  switch (arg)
+  {
+    case MW_Freq:
+      freq_show(freq_digit_select);
+      draw_thousands();
+      break;
+    case MW_Hz:
+      draw_hz();
+      break;
+    case MW_Band:
+      band_draw(true);
+      break;
+    case MW_Online:
+      drawOnline();
+      break;
+    case MW_AB:
+      drawABButton();
+      break;
+    case MW_Menu:
+      drawMenuButton();
+      break;
+  }
+}
+
+// main screen widgets in z-order, see overlay.h
+static const Widget main_widgets[] =
+{
+  {0, 0, SCREEN_WIDTH, DEPTH_FREQ_DISPLAY, FREQ_BG, NULL, 0},
+  {0, DEPTH_FREQ_DISPLAY, SCREEN_WIDTH, SCREEN_HEIGHT-DEPTH_FREQ_DISPLAY, SCREEN_BG2, NULL, 0},
+  {FREQ_OFFSET_X, 0, NUM_F_CHAR*CHAR_WIDTH + 2, DEPTH_FREQ_DISPLAY, 0, main_widget_draw, MW_Freq},
+  {MHZ_OFFSET_X, 0, SCREEN_WIDTH - MHZ_OFFSET_X, DEPTH_FREQ_DISPLAY, 0, main_widget_draw, MW_Hz},
+  {0, BAND_IND_Y, SCREEN_WIDTH, BAND_IND_H, 0, main_widget_draw, MW_Band},
+  {ONLINE_X, ONLINE_Y, ONLINE_WIDTH, ONLINE_HEIGHT, 0, main_widget_draw, MW_Online},
+  {ABBTN_X, ABBTN_Y, ABBTN_WIDTH, ABBTN_HEIGHT, 0, main_widget_draw, MW_AB},
+  {MENUBTN_X, MENUBTN_Y, MENUBTN_WIDTH, MENUBTN_HEIGHT, 0, main_widget_draw, MW_Menu},
+};
+
 //-----------------------------------------------
 // Draw the entire screen (the bits that don't change).
 //-----------------------------------------------
 
 void draw_screen(void)
 {
-  tft.setFont(FONT_FREQ);
+  PROFILE_ZONE(PZ_DrawScreen);
   tft.fillRect(0, DEPTH_FREQ_DISPLAY, tft.width(), SCREEN_HEIGHT-DEPTH_FREQ_DISPLAY, SCREEN_BG2);
   tft.setTextWrap(false);
-  tft.fillRoundRect(0, 0, tft.width(), DEPTH_FREQ_DISPLAY, 5, FREQ_BG);
   tft.fillRect(0, 0, tft.width(), DEPTH_FREQ_DISPLAY, FREQ_BG);
-  tft.setCursor(MHZ_OFFSET_X, TOP_BAR_Y);
-  tft.setTextColor(FREQ_FG);
-  tft.print("Hz");
+  draw_hz();
   drawOnline();
+  drawABButton();
   drawMenuButton();
+  overlay_screen(main_widgets, ALEN(main_widgets));
 }
 
 //-----------------------------------------------
-// Determine if screen was touched.
-//     x, y  pointers to cells to receive X and Y position
-// Returns 'false' if no touch, 'x' and 'y' cells NOT updated.
-// Returns 'true' if new touch found, 'x' and 'y' cells updated.
-// Returns 'true' only if new touch, ie, pen was UP last read.
+// Read the touch controller, the SPI bus job for the touch device.
+// It also runs while the display is drawing, so a new touch is latched
+// until pen_touch() returns it.
 //-----------------------------------------------
-bool pen_touch(int *x, int *y)
+static void touch_sample(void)
 {
-  // Retrieve a point  
   TS_Point p = ts.getPoint();
 
-  // if pen not DOWN, return false
+  // if pen not DOWN, nothing to do
   if (p.z < TOUCH_THRESHOLD)
   {
-    if (pen_down)
-      pen_down = false;
-    return false;
+    pen_down = false;
+    return;
   }
 
-  // pen is DOWN, if DOWN before, ignore
-  if (pen_down)
+  // pen is DOWN, if it was UP before we have a new touch
+  if (!pen_down && !touch_latched)
   {
-    return false;
+    touch_latched = true;
+    touch_point = p;
+    touch_time = micros();
   }
-
-  // otherwise we have a pen touch
   pen_down = true;
+}
+
+//-----------------------------------------------
+// Determine if screen was touched.
+//     x, y    pointers to cells to receive X and Y position
+//     screen  the type of screen polling, for latency measurement
+// Returns 'false' if no touch, 'x' and 'y' cells NOT updated.
+// Returns 'true' if new touch found, 'x' and 'y' cells updated.
+// Returns 'true' only if new touch, ie, pen was UP last read.
+//-----------------------------------------------
+bool pen_touch(int *x, int *y, LatencyScreen screen)
+{
+  PROFILE_ZONE(PZ_PenTouch);
+  // every event loop comes through here, so any drawing for the last
+  // touch is done, unless a main screen frame is still to come, and keep
+  // the mirror moving
+  tft.flush();
+  if (((screen != LAT_Main) && (screen != LAT_Keypad)) || !render_pending())
+    latency_poll();
+  console_drain();
+
+  // a touch may have been read while drawing, else read the touch
+  // controller, but when idle only when a touch is likely
+  if (!touch_latched)
+  {
+    if (!idle_sample_due(pen_down))
+    {
+      idle_sleep();
+      return false;
+    }
+
+    spi_run(SPI_Touch);
+    if (!touch_latched)
+      return false;
+  }
+
+  // we have a pen touch
+  touch_latched = false;
+  latency_touch(screen, touch_time);
+  idle_activity();
   
   // Scale from ~0->4000 to tft.width using the calibration #'s
-  *x = map(p.x, TS_MINX, TS_MAXX, 0, tft.width());
-  *y = map(p.y, TS_MINY, TS_MAXY, 0, tft.height());
+  *x = map(touch_point.x, TS_MINX, TS_MAXX, 0, tft.width());
+  *y = map(touch_point.y, TS_MINY, TS_MAXY, 0, tft.height());
 
   DEBUG("pen_down going TRUE, x=%d, y=%d\n", *x, *y);
   return true;
@@ -584,6 +836,8 @@ HotSpot hs_mainscreen[] =
   {ONLINE_X, ONLINE_Y, ONLINE_WIDTH, ONLINE_HEIGHT, online_hs_handler, -1},
   // the "Menu" button
   {MENUBTN_X, MENUBTN_Y, MENUBTN_WIDTH, MENUBTN_HEIGHT, menu_hs_handler, -2},
+  // the "A/B" button
+  {ABBTN_X, ABBTN_Y, ABBTN_WIDTH, ABBTN_HEIGHT, ab_hs_handler, -3},
 };
 
 #define MainscreenHSLen   ALEN(hs_mainscreen)
@@ -603,8 +857,98 @@ bool freq_hs_handler(HotSpot *hs)
   int offset = (int) hs->arg;
   
   freq_digit_select = offset;
-  keypad_show(offset);
-  return true;    // redraw the screen
+  return keypad_show(offset);
+}
+
+//-----------------------------------------------
+// Set the DDS to match the current VFO state.
+// Called whenever 'frequency' or 'vfo_state' changes.
+//-----------------------------------------------
+
+void vfo_retune(void)
+{
+  VFORegister *reg = &vfo_reg[vfo_active];
+
+  reg->freq = frequency;
+  reg->word = dds_word(frequency);
+
+  if (vfo_state == VFO_Online)
+    dds_load_word(reg->word);
+  else
+    dds_standby();
+
+  band_check(frequency);
+}
+
+//-----------------------------------------------
+// Make a VFO register the active one.
+//     num  index of the register to make active
+//
+// The register's tuning word is already computed, so this costs one DDS
+// load.  The digits that differ are redrawn at the next frame.
+//-----------------------------------------------
+
+void vfo_select(int num)
+{
+  if (num == vfo_active)
+    return;
+
+  // save the working copy back into the active register
+  VFORegister *reg = &vfo_reg[vfo_active];
+
+  reg->freq = frequency;
+  reg->digit = freq_digit_select;
+  freq_to_buff(reg->display, frequency);
+
+  // and make the other register the working copy
+  vfo_active = num;
+  reg = &vfo_reg[vfo_active];
+  frequency = reg->freq;
+  freq_digit_select = reg->digit;
+
+  if (vfo_state == VFO_Online)
+    dds_load_word(reg->word);
+
+  band_check(frequency);
+  render_mark(RD_FREQ | RD_AB | RD_BAND);
+}
+
+//-----------------------------------------------
+// Set the frequency of a VFO register.
+//     num   index of the register
+//     freq  the new frequency
+//
+// If the register is active the DDS is updated, and the display at the
+// next frame.
+//-----------------------------------------------
+
+void vfo_set_freq(int num, Frequency freq)
+{
+  VFORegister *reg = &vfo_reg[num];
+
+  if (num == vfo_active)
+  {
+    frequency = freq;
+    vfo_retune();
+    render_mark(RD_FREQ | RD_BAND);
+  }
+  else
+  {
+    reg->freq = freq;
+    reg->word = dds_word(freq);
+    freq_to_buff(reg->display, freq);
+  }
+}
+
+//-----------------------------------------------
+// Handle pressing the 'A/B' button.
+//     hs_ptr  a pointer to the actioned HotSpot item
+//-----------------------------------------------
+
+bool ab_hs_handler(HotSpot *hs_ptr)
+{
+  vfo_select(vfo_active ^ 1);
+  return false;   // don't redraw screen
 }
 
 //-----------------------------------------------
@@ -617,17 +961,16 @@ bool online_hs_handler(HotSpot *hs_ptr)
 {
   // toggle state and redraw the button
   if (vfo_state == VFO_Standby)
-  {
     vfo_state = VFO_Online;
-    // TODO: set up DDS
-  }
   else
-  {
     vfo_state = VFO_Standby;
-    // TODO: turn off DDS
-  }
-    
-  drawOnline();   // redraws button with appropriate text
+
+  // in split mode ONLINE uses register B, standby uses A
+  if (vfo_split)
+    vfo_select((vfo_state == VFO_Online) ? VFO_B : VFO_A);
+
+  vfo_retune();   // set up or turn off the DDS
+  render_mark(RD_ONLINE);
   return false;   // don't redraw screen
 }
 
@@ -671,10 +1014,12 @@ bool keypad_handler(HotSpot *hs)
   int offset = (int) hs->arg;
   
   freq_display[freq_digit_select] = '0' + offset;
+  frequency = freq_to_int(freq_display);
+  vfo_retune();
   freq_digit_select += 1;
   if (freq_digit_select >= NUM_F_CHAR)
     freq_digit_select = NUM_F_CHAR - 1;
-  freq_show(freq_digit_select);
+  render_mark(RD_SELECT);
   return false;   // don't redraw scren
 }
 
@@ -695,7 +1040,7 @@ bool keypad_freq_handler(HotSpot *hs)
   int offset = (int) hs->arg;
   
   freq_digit_select = offset;
-  freq_show(offset);
+  render_mark(RD_SELECT);
   return false;   // don't redraw screen
 }
 
@@ -725,6 +1070,7 @@ HotSpot hs_keypad[] =
 };  
 
 #define KeypadHSLen   ALEN(hs_keypad)
+#define KEYPAD_KEYS   12    // the keypad buttons, first in 'hs_keypad'
 
 //-----------------------------------------------
 // Draw a keypad button.
@@ -756,21 +1102,55 @@ void keypad_button_draw(char ch, int x, int y)
 }
 
 //-----------------------------------------------
-// Draw the keypad, handle interactions with it.
+// Redraw a keypad button, removing the press frame.
+//     hs  address of the button's hotspot
+//-----------------------------------------------
+
+void keypad_button_release(const HotSpot *hs)
+{
+  int i = hs - hs_keypad;
+
+  tft.fillRect(hs->x, hs->y, hs->w, hs->h, KEYPAD_BG);
+  keypad_button_draw((hs->arg >= 0) ? '0' + hs->arg : '#', i % 3, i / 3);
+}
+
+//-----------------------------------------------
+// Remove the press frame from a frequency digit hotspot.
+//     hs  address of the digit's hotspot
+//
+// The digit cells drawn by freq_show() start below the top of the
+// hotspot, so just that strip is cleared here.  The rest of the frame is
+// inside the cells, which the RD_SELECT frame marked by the handler redraws.
+//-----------------------------------------------
+
+void keypad_digit_release(const HotSpot *hs)
+{
+  tft.fillRect(hs->x, hs->y, hs->w, HS_PRESS_W, FREQ_BG);
+}
+
+//-----------------------------------------------
+// Draw the keypad over the main screen.
 //     offset  the index into the frequency buffer of digit to change.
 //
 // We highlight the digit we are going to change.
-// We have a small event loop here to handle the keypad.
 //-----------------------------------------------
 
-void keypad_show(int offset)
+void keypad_draw(int offset)
 {
-  // highlight the frequency digit we are changing
+  // highlight the frequency digit we are changing, the keypad edits
+  // the digits so bring them up to date first
   freq_digit_select = offset;
+  freq_to_buff(freq_display, frequency);
   freq_show(offset);
 
-  // remove the online/menu buttons
+  // remove the online/menu/AB buttons, the keypad covers them all
+  overlay_open();
+  overlay_cover(ONLINE_X, ONLINE_Y, ONLINE_WIDTH, ONLINE_HEIGHT);
+  overlay_cover(ABBTN_X, ABBTN_Y, ABBTN_WIDTH, ABBTN_HEIGHT);
+  overlay_cover(MENUBTN_X, MENUBTN_Y, MENUBTN_WIDTH, MENUBTN_HEIGHT);
+  overlay_cover(KEYPAD_X, KEYPAD_Y, KEYPAD_W, KEYPAD_H);
   undrawOnline();
+  undrawABButton();
   undrawMenuButton();
   
   // draw keypad basic outline
@@ -787,6 +1167,23 @@ void keypad_show(int offset)
   }
   keypad_button_draw('0', 1, 3);    // '0' is in non-linear place
   keypad_button_draw('#', 2, 3);    // '#' is in non-linear place
+}
+
+//-----------------------------------------------
+// Draw the keypad, handle interactions with it.
+//     offset  the index into the frequency buffer of digit to change.
+//
+// We have a small event loop here to handle the keypad.
+// Returns 'true' if the screen beneath could not be restored.
+//-----------------------------------------------
+
+bool keypad_show(int offset)
+{
+  { // profile the drawing, not the event loop
+    PROFILE_ZONE(PZ_KeypadShow);
+
+    keypad_draw(offset);
+  }
 
   // event loop
   while (true)
@@ -794,33 +1191,76 @@ void keypad_show(int offset)
     int x;    // pen touch coordinates
     int y;
   
-    if (pen_touch(&x, &y))
+    if (pen_touch(&x, &y, LAT_Keypad))
     {
       if (HotSpot *hs = hs_touched(x, y, hs_keypad, KeypadHSLen))
       {
+        hs_press(hs);
         (*hs->handler)(hs);
         if (hs->arg == -1)
-          return;
+        {
+          // put back what the keypad covered, unhighlight the digit
+          bool restored = overlay_close();
+
+          render_mark(RD_SELECT | RD_BAND);
+          return !restored;
+        }
+        if (hs - hs_keypad < KEYPAD_KEYS)
+          keypad_button_release(hs);
+        else
+          keypad_digit_release(hs);
       }
     }
+
+    render_tick(RD_SELECT);   // just the digits, the rest is under the keypad
   }
 }
 
+#ifdef ENCODER_ENABLE
+//-----------------------------------------------
+// Change the selected digit by the encoder steps.
+//     steps  signed number of steps
+//
+// With no digit selected, eg, after the keypad is closed, ENCODER_DIGIT
+// is stepped.
+//-----------------------------------------------
+
+void encoder_tune(int32_t steps)
+{
+  int digit = (freq_digit_select >= 0) ? freq_digit_select : ENCODER_DIGIT;
+  int64_t step = 1;
+  int64_t freq;
+
+  for (int i = NUM_F_CHAR - 1; i > digit; --i)
+    step *= 10;
+
+  freq = frequency + steps * step;
+  if (freq < 0)
+    freq = 0;
+  if (freq > VFO_MAX_FREQ)
+    freq = VFO_MAX_FREQ;
+
+  idle_activity();
+  vfo_set_freq(vfo_active, (Frequency) freq);
+}
+#endif
+
 //-----------------------------------------------
 // Setup the whole shebang.
 //-----------------------------------------------
 
 void setup(void)
 {
+  mem_init();         // before anything uses much stack
   Serial.begin(115200);
-  Serial.printf("PixelVFO %s.%s\n", MAJOR_VERSION, MINOR_VERSION);
+  profile_init();
+  console.printf("PixelVFO %s.%s\n", MAJOR_VERSION, MINOR_VERSION);
 
   eeprom_init();
+  dds_init();
 
-  // set up the VFO frequency data structures
-  frequency = 1000000L;
-  freq_digit_select = 0;                    // index of selected digit in frequency display
-  freq_to_buff(freq_display, 1000000L);
+  // set up the VFO registers as they were at power off
+  boot_restore();
 
   // initialize 'freq_char_x_offset' array
   int x_offset = FREQ_OFFSET_X;
@@ -833,25 +1273,28 @@ void setup(void)
   // start handling devices
   SPI.begin();
   
-  tft.begin();
-  tft.setRotation(1);
+  TFTPanel::begin(tft);
+  tft.setRotation(TFTPanel::rotation);
+  fill_init();
 
   ts.begin();
+  spi_job(SPI_Touch, touch_sample, TS_SAMPLE_MS);
+  idle_init(TS_IRQ);
+  encoder_init();
+  snapshot_init(&menu_main);
   
-  // draw the basic screen
+  // draw the first screen with the display off, so it appears in one go
+  tft.sendCommand(ILI9341_DISPOFF);
   draw_screen();
-  
-  // draw the 'thousands' markers
   draw_thousands();
-
-//#if 0
-  // draw the 'edge of digits' markers
-  for (int i = 0; i <= NUM_F_CHAR; ++i)
-    tft.drawFastVLine(freq_char_x_offset[i], 44, 6, ILI9341_RED);
-//#endif
-
-  // show the frequency
   freq_show();
+  band_check(frequency);
+  band_draw(true);
+  tft.flush();
+  tft.sendCommand(ILI9341_DISPON);
+
+  // the rest waits until the screen is up
+  boot_ready();
 }
 
 //-----------------------------------------------
@@ -861,14 +1304,49 @@ void loop()
 {
   int x;      // pen touch coordinates
   int y;
+
+  boot_finish();
+  boot_poll();
+  log_flush();
+
+  switch (mem_check())
+  {
+    case MEM_Ok:
+      break;
+    case MEM_Stack:
+      abort("Stack overflow, stack/heap collision!");
+      break;
+    case MEM_Heap:
+      abort("Heap overflow, stack/heap collision!");
+      break;
+  }
+
+  cat_poll();
+
+#ifdef ENCODER_ENABLE
+  if (int32_t steps = encoder_take())
+    encoder_tune(steps);
+#endif
+
+  if (mirror_poll())
+    render_mark(RD_SCREEN);   // mirror has started a full frame
   
-  if (pen_touch(&x, &y))
+  if (pen_touch(&x, &y, LAT_Main))
   {
     if (HotSpot *hs = hs_touched(x, y, hs_mainscreen, MainscreenHSLen))
     {
-      (*hs->handler)(hs);
-      draw_screen();
-      freq_show();
+      hs_press(hs);
+      if ((*hs->handler)(hs))
+      {
+        render_mark(RD_SCREEN);
+      }
+      else
+      {
+        hs_release(hs);
+        render_mark(RD_BAND);   // only drawn if band changed
+      }
     }
   }
+
+  render_tick(RD_ALL);
 }
@@ -10,37 +10,51 @@
 #include "PixelVFO.h"
 #include "hotspot.h"
 #include "menu.h"
+#include "actions.h"
 #include "eeprom.h"
 #include "utils.h"
+#include "sweep.h"
+#include "scan.h"
+#include "dds.h"
+#include "calibrate.h"
+#include "memory.h"
+#include "text.h"
+#include "monitor.h"
+#include "stripchart.h"
+#include "overlay.h"
+
+#define MONITOR_BG      ILI9341_BLACK
+#define MONITOR_FG      ILI9341_GREEN
 
 //-----------------------------------------------
 // Reset - no action.
 //-----------------------------------------------
 
-bool action_no_reset(void *ignore)
+bool action_no_reset(int ignore)
 {
   DEBUG("action_no_reset: called\n");
   util_alert("Test of alert.");
-  return true;    // redraw screen
+  return false;   // menu restored under the alert
 }
 
 //-----------------------------------------------
 // Reset - perform action.
 //-----------------------------------------------
 
-bool action_reset(void *ignore)
+bool action_reset(int ignore)
 {
   DEBUG("action_reset: called\n");
   bool result = util_confirm("Test of confirm.");
+  (void) result;    // only logged
   DEBUG("confirm dialog returned '%s'\n", (result) ? "true" : "false");
-  return true;   // don't redraw screen
+  return false;   // menu restored under the dialog
 }
 
 //-----------------------------------------------
 // Settings - adjust brightness.
 //-----------------------------------------------
 
-bool action_brightness(void *ignore)
+bool action_brightness(int ignore)
 {
   DEBUG("action_brightness: called\n");
   return false;   // don't redraw screen
@@ -48,12 +62,180 @@ bool action_brightness(void *ignore)
 
 //-----------------------------------------------
 // Settings - calibrate the DDS-60 chip.
+//
+// Measures the DDS error at each calibration point against the 1PPS
+// reference.  Touching the screen abandons the calibration.
 //-----------------------------------------------
 
-bool action_calibrate(void *ignore)
+bool action_calibrate(int ignore)
 {
   DEBUG("action_calibrate: called\n");
-  return false;   // don't redraw screen
+
+  if (!util_confirm("Reference connected?"))
+    return false;   // menu restored under the dialog
+
+  int32_t saved_ppb[CAL_NUM_POINTS];
+  bool ok = true;
+
+  memcpy(saved_ppb, cal_ppb, sizeof(saved_ppb));
+
+  // draw the calibration screen, it has no widget table for the final alert
+  overlay_screen(NULL, 0);
+  tft.fillRect(0, 0, tft.width(), tft.height(), MENU_BG);
+  tft.fillRect(0, 0, tft.width(), DEPTH_FREQ_DISPLAY, FREQ_BG);
+  tft.setTextColor(MENU_FG);
+  tft.setFont(FONT_MENU);
+  tft.setCursor(TITLE_OFFSET_X, TITLE_OFFSET_Y);
+  tft.print("Calibrate");
+  tft.setFont(FONT_DIALOG);
+
+  // measure the raw error, so no correction while measuring
+  memset(cal_ppb, 0, sizeof(cal_ppb));
+  cal_apply();
+
+  for (int i = 1; ok && (i < CAL_NUM_POINTS); ++i)
+  {
+    Frequency freq = cal_points[i];
+    int x;    // pen touch coordinates
+    int y;
+
+    tft.setCursor(10, DEPTH_FREQ_DISPLAY + 20 * i);
+    tft.printf("%8ldHz: ", freq);
+
+    cal_gate_start(freq);
+    while (!cal_gate_done())
+    {
+      if (millis() - cal_gate_time >= CAL_TIMEOUT)
+      {
+        DEBUG("action_calibrate: no reference signal\n");
+        tft.print("no reference");
+        ok = false;
+        break;
+      }
+      if (pen_touch(&x, &y, LAT_Dialog))
+      {
+        ok = false;
+        break;
+      }
+    }
+    cal_gate_stop();
+
+    if (ok)
+    {
+      cal_ppb[i] = cal_gate_error(freq);
+      tft.printf("%ldppb", cal_ppb[i]);
+      DEBUG("action_calibrate: %ldHz, error %ldppb\n", freq, cal_ppb[i]);
+    }
+  }
+
+  if (ok)
+    cal_save();
+  else
+    memcpy(cal_ppb, saved_ppb, sizeof(cal_ppb));
+  cal_apply();
+
+  // the VFO registers hold tuning words made with the old table
+  for (int i = 0; i < 2; ++i)
+    vfo_reg[i].word = dds_word(vfo_reg[i].freq);
+  vfo_retune();
+
+  util_alert((ok) ? "Calibration saved." : "Calibration abandoned.");
+  return true;    // redraw screen
+}
+
+//-----------------------------------------------
+// Settings - turn split mode on or off.
+//-----------------------------------------------
+
+bool action_split(int ignore)
+{
+  vfo_split = !vfo_split;
+  DEBUG("action_split: vfo_split=%s\n", (vfo_split) ? "true" : "false");
+  util_alert((vfo_split) ? "Split is ON." : "Split is OFF.");
+  return false;   // menu restored under the alert
+}
+
+//-----------------------------------------------
+// Monitor - plot the detector voltage until the screen is touched.
+//-----------------------------------------------
+
+bool action_monitor(int ignore)
+{
+  DEBUG("action_monitor: called\n");
+
+  // draw the monitor screen
+  tft.fillRect(0, 0, tft.width(), DEPTH_FREQ_DISPLAY, FREQ_BG);
+  tft.setTextColor(MENU_FG);
+  tft.setFont(FONT_MENU);
+  tft.setCursor(TITLE_OFFSET_X, TITLE_OFFSET_Y);
+  tft.print("Monitor");
+
+  chart_init(&monitor_chart, 0, DEPTH_FREQ_DISPLAY, tft.width(),
+             tft.height() - DEPTH_FREQ_DISPLAY, 0, (1 << MONITOR_BITS) - 1,
+             MONITOR_FG, MONITOR_BG);
+  chart_draw(&monitor_chart);
+
+  monitor_start();
+
+  while (true)
+  {
+    int32_t value;
+    int x;    // pen touch coordinates
+    int y;
+
+    while (monitor_get(&value))
+      chart_add(&monitor_chart, value);
+
+    if (pen_touch(&x, &y, LAT_Dialog))
+      break;
+  }
+
+  monitor_stop();
+  DEBUG("action_monitor: %lu samples, %lu pixels, max %u per sample, %lu dropped\n",
+        monitor_chart.samples, monitor_chart.pixels,
+        monitor_chart.max_pixels, monitor_dropped());
+  return true;    // redraw screen
+}
+
+//-----------------------------------------------
+// Settings - show the RAM usage, touch anywhere to leave.
+//-----------------------------------------------
+
+bool action_memory(int ignore)
+{
+  MemInfo info;
+
+  mem_info(&info);
+  dump_mem("action_memory");
+
+  // draw the memory screen
+  tft.fillRect(0, 0, tft.width(), tft.height(), MENU_BG);
+  tft.fillRect(0, 0, tft.width(), DEPTH_FREQ_DISPLAY, FREQ_BG);
+  tft.setTextColor(MENU_FG);
+  tft.setFont(FONT_MENU);
+  tft.setCursor(TITLE_OFFSET_X, TITLE_OFFSET_Y);
+  tft.print("Memory");
+  tft.setFont(FONT_DIALOG);
+
+  tft.setCursor(10, DEPTH_FREQ_DISPLAY + 20);
+  tft.printf("Static data: %6lu bytes", info.static_size);
+  tft.setCursor(10, DEPTH_FREQ_DISPLAY + 40);
+  tft.printf("Heap used:   %6lu of %lu", info.heap_used, info.heap_size);
+  tft.setCursor(10, DEPTH_FREQ_DISPLAY + 60);
+  tft.printf("Heap peak:   %6lu bytes", info.heap_peak);
+  tft.setCursor(10, DEPTH_FREQ_DISPLAY + 80);
+  tft.printf("Stack peak:  %6lu bytes", info.stack_peak);
+  tft.setCursor(10, DEPTH_FREQ_DISPLAY + 100);
+  tft.printf("Never used:  %6lu bytes", info.stack_free);
+
+  while (true)
+  {
+    int x;    // pen touch coordinates
+    int y;
+
+    if (pen_touch(&x, &y, LAT_Dialog))
+      return true;    // redraw screen
+  }
 }
 
 //-----------------------------------------------
@@ -62,7 +244,7 @@ bool action_calibrate(void *ignore)
 
 bool act_menuslot_handler(HotSpot *hs, void *arg)
 {
-  MenuItem *mi_ptr = NULL;
+  const MenuItem *mi_ptr = NULL;
   bool result = false;
   
   DEBUG(">>>>> act_menuslot_handler: entered, hs=\n%s\nmi=\n%s\n",
@@ -96,40 +278,46 @@ bool act_scroll_down(HotSpot *hs, void *arg)
 // Slots
 //***********************************************
 
-bool act_save_slot(void *arg)
+bool act_save_slot(int arg)
 {
-  int slot_num = (int) arg;
+  int slot_num = arg;
   DEBUG("act_save_slot: called, slot_num=%d, returning 'true'\n", slot_num);
   slot_put(slot_num, frequency, freq_digit_select);
   return true;
 }
 
-// slots menu - menu and menuitem titles and menuitem action value filled in dynamically
-struct MenuItem act_slot0 = {NULL, NULL, act_save_slot, (void *) 0};
-struct MenuItem act_slot1 = {NULL, NULL, act_save_slot, (void *) 1};
-struct MenuItem act_slot2 = {NULL, NULL, act_save_slot, (void *) 2};
-struct MenuItem act_slot3 = {NULL, NULL, act_save_slot, (void *) 3};
-struct MenuItem act_slot4 = {NULL, NULL, act_save_slot, (void *) 4};
-struct MenuItem act_slot5 = {NULL, NULL, act_save_slot, (void *) 5};
-struct MenuItem act_slot6 = {NULL, NULL, act_save_slot, (void *) 6};
-struct MenuItem act_slot7 = {NULL, NULL, act_save_slot, (void *) 7};
-struct MenuItem act_slot8 = {NULL, NULL, act_save_slot, (void *) 8};
-struct MenuItem act_slot9 = {NULL, NULL, act_save_slot, (void *) 9};
+// slots menu - menu and menuitem title text filled in dynamically
+#define SlotTitleLength     (15 + 1)    // +1 for NULL byte end-of-string
+#define SlotBufferLength    (13 + 1)    // +1 for NULL byte end-of-string
+#define NumSlots            10
+
+static char slot_title[SlotTitleLength];
+static char slot_text[NumSlots][SlotBufferLength];
+
+constexpr MenuItem mia_f_slots[] =
+{
+  {slot_text[0], NULL, act_save_slot, 0},
+  {slot_text[1], NULL, act_save_slot, 1},
+  {slot_text[2], NULL, act_save_slot, 2},
+  {slot_text[3], NULL, act_save_slot, 3},
+  {slot_text[4], NULL, act_save_slot, 4},
+  {slot_text[5], NULL, act_save_slot, 5},
+  {slot_text[6], NULL, act_save_slot, 6},
+  {slot_text[7], NULL, act_save_slot, 7},
+  {slot_text[8], NULL, act_save_slot, 8},
+  {slot_text[9], NULL, act_save_slot, 9},
+};
 
-struct MenuItem *mia_f_slots[] = {
-                                  &act_slot0, &act_slot1, &act_slot2, &act_slot3, &act_slot4,
-                                  &act_slot5, &act_slot6, &act_slot7, &act_slot8, &act_slot9,
-                                 };
+static_assert(ALEN(mia_f_slots) == NumSlots, "slot menu and buffers differ");
 
-struct Menu menu_slots = {NULL, 0, ALEN(mia_f_slots), mia_f_slots, true};
+constexpr Menu menu_slots = {slot_title, ALEN(mia_f_slots), mia_f_slots, true};
+
+static_assert(menu_valid(&menu_slots), "bad slots menu");
 
 //-----------------------------------------------
 // Populate the slots menu above with data about the saved slots
 //-----------------------------------------------
 
-#define SlotTitleLength     (15 + 1)    // +1 for NULL byte end-of-string
-#define SlotBufferLength    (13 + 1)    // +1 for NULL byte end-of-string
-
 void slots_populate(const char *menu_title)
 {
   DEBUG("slots_populate: called\n");
@@ -138,16 +326,10 @@ void slots_populate(const char *menu_title)
   SelOffset offset;
   int address = SaveFreqBase;
 
-  // if no menu title buffer, create it
-  if (menu_slots.title == NULL)
-  {
-    menu_slots.title = (const char *) malloc(SlotTitleLength);
-  }
-  strcpy((char *) menu_slots.title, (const char *) menu_title);
+  strncpy(slot_title, menu_title, SlotTitleLength - 1);
   
   for (unsigned int i = 0; i < ALEN(mia_f_slots); ++i)
   {
-    MenuItem *mi_ptr = mia_f_slots[i];
     if (i == 1)
     {
       frequency = 12345678;
@@ -156,22 +338,18 @@ void slots_populate(const char *menu_title)
     else
       slot_get(address, frequency, offset);
 
-    // if no slot display buffer, create it
-    if (mi_ptr->title == NULL)
-    {
-      mi_ptr->title = (const char *) malloc(SlotBufferLength);
-    }
-
     // create slot menuitem title text
     if (frequency > 0)
     {
-      sprintf((char *) mi_ptr->title, "%8ldHz", frequency);
+      snprintf(slot_text[i], SlotBufferLength, "%8ldHz", frequency);
     }
     else
     {
-      sprintf((char *) mi_ptr->title, "          ");
+      snprintf(slot_text[i], SlotBufferLength, "          ");
     }
 
+    text_forget(slot_text[i]);
+
     // move to next slot address
     ++address;
   }
@@ -181,7 +359,7 @@ void slots_populate(const char *menu_title)
 // Slots - save frequency to a slot.
 //-----------------------------------------------
 
-bool action_slot_save(void *ignore)
+bool action_slot_save(int ignore)
 {
   DEBUG("action_slot_save: called\n");
 
@@ -193,15 +371,15 @@ bool action_slot_save(void *ignore)
 
   // event loop here
   
-  DEBUG("action_slot_save: returning 'false'\n");
-  return false;   // don't redraw screen
+  DEBUG("action_slot_save: returning 'true'\n");
+  return true;    // redraw the menu we return to
 }
 
 //-----------------------------------------------
 // Slots - restore frequency from a slot.
 //-----------------------------------------------
 
-bool action_slot_restore(void *ignore)
+bool action_slot_restore(int ignore)
 {
   // populate the slot menuitems with current saved slot data
   slots_populate("Restore slot");
@@ -212,14 +390,14 @@ bool action_slot_restore(void *ignore)
   // event loop here
   
   DEBUG("action_slot_restore: called\n");
-  return false;   // don't redraw screen
+  return true;    // redraw the menu we return to
 }
 
 //-----------------------------------------------
 // Slots - delete contents in a slot.
 //-----------------------------------------------
 
-bool action_slot_delete(void *ignore)
+bool action_slot_delete(int ignore)
 {
   // populate the slot menuitems with current saved slot data
   slots_populate("Delete slot");
@@ -230,6 +408,173 @@ bool action_slot_delete(void *ignore)
   // event loop here
   
   DEBUG("action_slot_delete: called\n");
-  return false;   // don't redraw screen
+  return true;    // redraw the menu we return to
+}
+
+
+//***********************************************
+// Sweep
+//***********************************************
+
+//-----------------------------------------------
+// Sweep - set the sweep start/stop to the current frequency.
+//-----------------------------------------------
+
+bool action_sweep_setstart(int ignore)
+{
+  char buff[32];
+
+  sweep_start_freq = frequency;
+  sprintf(buff, "Start: %ldHz", sweep_start_freq);
+  util_alert(buff);
+  return false;   // menu restored under the alert
+}
+
+bool action_sweep_setstop(int ignore)
+{
+  char buff[32];
+
+  sweep_stop_freq = frequency;
+  sprintf(buff, "Stop: %ldHz", sweep_stop_freq);
+  util_alert(buff);
+  return false;   // menu restored under the alert
+}
+
+//-----------------------------------------------
+// Sweep - set the step size and dwell time.
+//-----------------------------------------------
+
+bool act_sweep_step(int arg)
+{
+  sweep_step_freq = (Frequency) arg;
+  DEBUG("act_sweep_step: sweep_step_freq=%ld\n", sweep_step_freq);
+  return true;
+}
+
+bool act_sweep_dwell(int arg)
+{
+  sweep_dwell = (unsigned long) arg;
+  DEBUG("act_sweep_dwell: sweep_dwell=%ld\n", sweep_dwell);
+  return true;
+}
+
+constexpr MenuItem mia_sweep_step[] =
+{
+  {"1Hz", NULL, act_sweep_step, 1},
+  {"10Hz", NULL, act_sweep_step, 10},
+  {"100Hz", NULL, act_sweep_step, 100},
+  {"1kHz", NULL, act_sweep_step, 1000},
+  {"10kHz", NULL, act_sweep_step, 10000},
+  {"100kHz", NULL, act_sweep_step, 100000},
+};
+
+constexpr Menu menu_sweep_step = {"Sweep step", ALEN(mia_sweep_step), mia_sweep_step, false};
+
+static_assert(menu_valid(&menu_sweep_step), "bad sweep step menu");
+
+constexpr MenuItem mia_sweep_dwell[] =
+{
+  {"20us", NULL, act_sweep_dwell, 20},
+  {"100us", NULL, act_sweep_dwell, 100},
+  {"1ms", NULL, act_sweep_dwell, 1000},
+  {"10ms", NULL, act_sweep_dwell, 10000},
+  {"100ms", NULL, act_sweep_dwell, 100000},
+};
+
+constexpr Menu menu_sweep_dwell = {"Sweep dwell", ALEN(mia_sweep_dwell), mia_sweep_dwell, false};
+
+static_assert(menu_valid(&menu_sweep_dwell), "bad sweep dwell menu");
+
+//-----------------------------------------------
+// Sweep - run the sweep until the user presses "Back".
+//-----------------------------------------------
+
+bool hs_sweepback_handler(HotSpot *hs)
+{
+  DEBUG("hs_sweepback_handler: called\n");
+  return true;    // redraw screen
 }
 
+static HotSpot hs_sweep[] =
+{
+  {0, 0, ts_width, DEPTH_FREQ_DISPLAY, hs_sweepback_handler, 0},
+};
+
+#define SweepHSLen   ALEN(hs_sweep)
+
+bool action_sweep_run(int ignore)
+{
+  int steps = sweep_prepare();
+
+  if (steps == 0)
+  {
+    util_alert("Bad sweep settings.");
+    return false;   // menu restored under the alert
+  }
+
+  // draw the sweep screen
+  tft.fillRect(0, 0, tft.width(), tft.height(), MENU_BG);
+  tft.fillRect(0, 0, tft.width(), DEPTH_FREQ_DISPLAY, FREQ_BG);
+  tft.setTextColor(MENU_FG);
+  tft.setFont(FONT_MENU);
+  tft.setCursor(TITLE_OFFSET_X, TITLE_OFFSET_Y);
+  tft.print("Sweep");
+  menuBackButton();
+  tft.setFont(FONT_MENUITEM);
+  tft.setCursor(10, 90);
+  tft.printf("Start: %ldHz", sweep_start_freq);
+  tft.setCursor(10, 125);
+  tft.printf("Stop: %ldHz", sweep_start_freq + (steps - 1) * sweep_step_freq);
+  tft.setCursor(10, 160);
+  tft.printf("Step: %ldHz", sweep_step_freq);
+  tft.setCursor(10, 195);
+  tft.printf("Dwell: %ldus, %d steps", sweep_dwell, steps);
+
+  sweep_start();
+
+  // event loop, the sweep runs from the timer
+  while (true)
+  {
+    int x;    // pen touch coordinates
+    int y;
+
+    if (pen_touch(&x, &y, LAT_Dialog))
+    {
+      if (HotSpot *hs = hs_touched(x, y, hs_sweep, SweepHSLen))
+      {
+        (*hs->handler)(hs);
+        break;
+      }
+    }
+  }
+
+  sweep_stop();
+  vfo_retune();   // put the DDS back the way it was
+
+  DEBUG("action_sweep_run: returning 'true'\n");
+  return true;    // redraw screen
+}
+
+//***********************************************
+// Scan
+//***********************************************
+
+bool act_scan_dwell(int arg)
+{
+  scan_dwell = (unsigned long) arg;
+  DEBUG("act_scan_dwell: scan_dwell=%ld\n", scan_dwell);
+  return true;
+}
+
+constexpr MenuItem mia_scan_dwell[] =
+{
+  {"1s", NULL, act_scan_dwell, 1000},
+  {"2s", NULL, act_scan_dwell, 2000},
+  {"5s", NULL, act_scan_dwell, 5000},
+  {"10s", NULL, act_scan_dwell, 10000},
+  {"30s", NULL, act_scan_dwell, 30000},
+};
+
+constexpr Menu menu_scan_dwell = {"Scan dwell", ALEN(mia_scan_dwell), mia_scan_dwell, false};
+
+static_assert(menu_valid(&menu_scan_dwell), "bad scan dwell menu");
@@ -17,13 +17,25 @@
 // definitions for all action handlers.
 //-----------------------------------------------
 
-bool action_no_reset(void *);
-bool action_reset(void *);
-bool action_brightness(void *);
-bool action_calibrate(void *);
-bool action_slot_save(void *);
-bool action_slot_restore(void *);
-bool action_slot_delete(void *);
+bool action_no_reset(int);
+bool action_reset(int);
+bool action_brightness(int);
+bool action_calibrate(int);
+bool action_split(int);
+bool action_memory(int);
+bool action_monitor(int);
+bool action_slot_save(int);
+bool action_slot_restore(int);
+bool action_slot_delete(int);
+bool action_sweep_run(int);
+bool action_sweep_setstart(int);
+bool action_sweep_setstop(int);
+
+// sub-menus built in actions.cpp
+extern const struct Menu menu_sweep_step;
+extern const struct Menu menu_sweep_dwell;
+extern const struct Menu menu_scan_dwell;
+
 //bool hs_creditsback_handler(HotSpot *hs, void *ignore);
 
 #endif
@@ -0,0 +1,246 @@
+////////////////////////////////////////////////////////////////////////////////
+// EEPROM backup and restore over the CAT serial port for PixelVFO.
+//
+// The frame format and the commands are described in backup.h.  The CAT
+// engine passes the commands in, without the ';', and sends the replies.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "PixelVFO.h"
+#include "backup.h"
+#include "eeprom.h"
+#include "calibrate.h"
+#include "dds.h"
+#include "profile.h"
+#include "boot.h"
+#include "render.h"
+
+#define BACKUP_CRC_INIT   0xFFFF
+
+static uint32_t backup_image[(EepromImageSize + 3) / 4];   // restore being received
+static bool backup_started = false;     // 'true' after a good "ZWssss,cccc;"
+static uint16_t backup_image_crc;       // image CRC from the host
+static int backup_next;                 // offset of next frame expected
+
+//----------------------------------------
+// Add bytes to a CRC-16/CCITT.
+//     crc   the CRC so far, BACKUP_CRC_INIT to start
+//     data  address of the bytes
+//     len   number of bytes
+// Returns the new CRC.
+//----------------------------------------
+
+uint16_t backup_crc(uint16_t crc, const uint8_t *data, int len)
+{
+  for (int i = 0; i < len; ++i)
+  {
+    crc ^= (uint16_t) data[i] << 8;
+    for (int bit = 0; bit < 8; ++bit)
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+  }
+
+  return crc;
+}
+
+//----------------------------------------
+// Get the CRC of a frame.
+//     offset  image offset of the frame
+//     data    address of the frame data
+//     len     number of data bytes
+//----------------------------------------
+
+static uint16_t frame_crc(int offset, const uint8_t *data, int len)
+{
+  uint8_t head[2] = {(uint8_t) (offset >> 8), (uint8_t) offset};
+
+  return backup_crc(backup_crc(BACKUP_CRC_INIT, head, 2), data, len);
+}
+
+//----------------------------------------
+// Parse a fixed number of hex digits.
+//     str     address of first digit
+//     num     number of digits to parse
+//     result  reference to cell to receive value
+// Returns 'false' if a character isn't a hex digit.
+//----------------------------------------
+
+static bool hex_number(const char *str, int num, unsigned long &result)
+{
+  result = 0;
+
+  for (int i = 0; i < num; ++i)
+  {
+    if (!isxdigit(str[i]))
+      return false;
+    result = (result << 4) | (isdigit(str[i]) ? str[i] - '0' : toupper(str[i]) - 'A' + 10);
+  }
+
+  return true;
+}
+
+//----------------------------------------
+// Handle a "ZR" command, read the image size or one frame.
+//     cmd    the command, without the ';'
+//     len    length of 'cmd'
+//     reply  buffer for the reply, CAT_MAX_COMMAND long
+// Returns 'false' if the command was bad.
+//----------------------------------------
+
+bool backup_read(const char *cmd, int len, char *reply)
+{
+  uint8_t data[BACKUP_CHUNK];
+
+  if (len == 2)
+  {
+    uint16_t crc = BACKUP_CRC_INIT;
+
+    for (int i = 0; i < EepromImageSize; ++i)
+    {
+      data[0] = EEPROM.read(i);
+      crc = backup_crc(crc, data, 1);
+    }
+    sprintf(reply, "ZR%04X,%04X;", EepromImageSize, crc);
+    return true;
+  }
+
+  unsigned long offset;
+
+  if ((len != 6) || !hex_number(cmd + 2, 4, offset) || (offset >= (unsigned long) EepromImageSize))
+    return false;
+
+  int num = min(BACKUP_CHUNK, EepromImageSize - (int) offset);
+  char *p = reply + sprintf(reply, "ZR%04lX", offset);
+
+  for (int i = 0; i < num; ++i)
+  {
+    data[i] = EEPROM.read(offset + i);
+    p += sprintf(p, "%02X", data[i]);
+  }
+  sprintf(p, "%04X;", frame_crc(offset, data, num));
+  return true;
+}
+
+//----------------------------------------
+// Handle a "ZW" command, start a restore or take one frame.
+//     cmd    the command, without the ';'
+//     len    length of 'cmd'
+//     reply  buffer for the reply, CAT_MAX_COMMAND long
+// Returns 'false' if the command or frame was bad.
+//----------------------------------------
+
+bool backup_write(const char *cmd, int len, char *reply)
+{
+  unsigned long offset;
+  unsigned long crc;
+
+  if ((len == 11) && (cmd[6] == ','))
+  {
+    unsigned long size;
+
+    if (!hex_number(cmd + 2, 4, size) || !hex_number(cmd + 7, 4, crc))
+      return false;
+    if (size != (unsigned long) EepromImageSize)
+    {
+      DEBUG("backup_write: image is %lu bytes, expected %d\n", size, EepromImageSize);
+      return false;
+    }
+
+    backup_started = true;
+    backup_image_crc = crc;
+    backup_next = 0;
+    strcpy(reply, "ZW0000;");
+    return true;
+  }
+
+  // a frame, offset, at least one data byte and the CRC
+  int num = (len - 10) / 2;
+  uint8_t data[BACKUP_CHUNK];
+
+  if (!backup_started || (len < 12) || (len & 1) || (num > BACKUP_CHUNK))
+    return false;
+  if (!hex_number(cmd + 2, 4, offset) || !hex_number(cmd + len - 4, 4, crc))
+    return false;
+
+  // a frame may be sent again, but not leave a gap
+  if (((int) offset > backup_next) || ((int) offset + num > EepromImageSize))
+    return false;
+
+  for (int i = 0; i < num; ++i)
+  {
+    unsigned long byte;
+
+    if (!hex_number(cmd + 6 + i*2, 2, byte))
+      return false;
+    data[i] = byte;
+  }
+
+  if (frame_crc(offset, data, num) != crc)
+  {
+    DEBUG("backup_write: bad CRC on frame at %lu\n", offset);
+    return false;
+  }
+
+  memcpy((uint8_t *) backup_image + offset, data, num);
+  backup_next = max(backup_next, (int) offset + num);
+  sprintf(reply, "ZW%04X;", backup_next);
+  return true;
+}
+
+//----------------------------------------
+// Write the received image to EEPROM, only the words that differ, and
+// put the VFO in the restored state.
+// Returns the number of words written, -1 if the image is incomplete or
+// its CRC is wrong.
+//----------------------------------------
+
+int backup_commit(void)
+{
+  PROFILE_ZONE(PZ_BackupCommit);
+  const uint8_t *image = (const uint8_t *) backup_image;
+
+  if (!backup_started || (backup_next < EepromImageSize))
+    return -1;
+
+  backup_started = false;
+  if (backup_crc(BACKUP_CRC_INIT, image, EepromImageSize) != backup_image_crc)
+  {
+    DEBUG("backup_commit: bad image CRC\n");
+    return -1;
+  }
+
+  int written = 0;
+  int addr = 0;
+
+  // whole words, each changed word is one EEPROM write
+  for ( ; addr + 4 <= EepromImageSize; addr += 4)
+  {
+    uint32_t *ee = (uint32_t *) (uintptr_t) addr;
+
+    if (eeprom_read_dword(ee) != backup_image[addr / 4])
+    {
+      eeprom_write_dword(ee, backup_image[addr / 4]);
+      ++written;
+    }
+  }
+
+  // any odd bytes at the end
+  for ( ; addr < EepromImageSize; ++addr)
+  {
+    if (EEPROM.read(addr) != image[addr])
+    {
+      EEPROM.update(addr, image[addr]);
+      ++written;
+    }
+  }
+
+  // the restored VFO state and calibration replace the ones in use, else
+  // boot_poll() would save the old state over the restored snapshot
+  boot_restore();
+  cal_init();
+  for (int i = 0; i < 2; ++i)
+    vfo_reg[i].word = dds_word(vfo_reg[i].freq);
+  vfo_retune();
+  render_mark(RD_SCREEN);
+
+  DEBUG("backup_commit: %d words written\n", written);
+  return written;
+}
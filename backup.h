@@ -0,0 +1,43 @@
+#ifndef BACKUP_H
+#define BACKUP_H
+
+////////////////////////////////////////////////////////////////////////////////
+// EEPROM backup and restore over the CAT serial port for PixelVFO.
+//
+// The image is the whole EEPROM layout of eeprom.h, EepromImageSize bytes:
+// the slots and their offsets, the calibration table, the VFO snapshot and
+// the markers.  It moves in frames of at most BACKUP_CHUNK bytes, coded as
+// hex inside CAT commands:
+//
+//     ZR;                  reply ZRssss,cccc;  image size and image CRC
+//     ZRoooo;              reply ZRoooo<data>kkkk;  the frame at 'oooo'
+//     ZWssss,cccc;         start a restore, reply ZW0000;
+//     ZWoooo<data>kkkk;    a restore frame, reply ZWnnnn;  next offset
+//     ZC;                  write the restored image, reply ZCnnnn;
+//
+// Numbers are 4 hex digits and data is 2 hex digits a byte.  'kkkk' is the
+// frame CRC, over the two offset bytes (high first) and the data.  'cccc'
+// is the CRC of the whole image.  Both are CRC-16/CCITT (poly 0x1021,
+// initial value 0xFFFF).  A bad frame gets "?;" and may be sent again, as
+// may a frame that was accepted but whose reply was lost.  The host waits
+// for each reply before sending the next frame, which is the flow control.
+//
+// The restore is held in RAM until "ZC;".  Nothing is written unless every
+// frame arrived and the image CRC matches.  Only changed 32 bit words are
+// written, each as a single EEPROM write, and 'nnnn' in the ZC reply is the
+// number written.  The calibration and the VFO snapshot are applied at
+// once, as if the VFO had booted with the image, so the snapshot isn't
+// saved over by the state from before the restore.  tools/eeprom_backup.py
+// is the host side.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+
+#define BACKUP_CHUNK    16      // most data bytes in one frame
+
+uint16_t backup_crc(uint16_t crc, const uint8_t *data, int len);
+bool backup_read(const char *cmd, int len, char *reply);
+bool backup_write(const char *cmd, int len, char *reply);
+int backup_commit(void);
+
+#endif
@@ -0,0 +1,193 @@
+////////////////////////////////////////////////////////////////////////////////
+// The amateur band plan for PixelVFO.
+//
+// The tables are constexpr so they live in flash, and their ordering is
+// checked at compile time.  Frequencies follow the IARU Region 3 plan.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "bandplan.h"
+
+static constexpr Band bands[] =
+{
+  { 1800000L,  1875000L, "160m"},
+  { 3500000L,  3800000L, "80m"},
+  { 7000000L,  7300000L, "40m"},
+  {10100000L, 10150000L, "30m"},
+  {14000000L, 14350000L, "20m"},
+  {18068000L, 18168000L, "17m"},
+  {21000000L, 21450000L, "15m"},
+  {24890000L, 24990000L, "12m"},
+  {28000000L, 29700000L, "10m"},
+  {50000000L, 54000000L, "6m"},
+};
+
+static constexpr BandSegment segments[] =
+{
+  { 1800000L,  1840000L, 0, "CW"},
+  { 1840000L,  1875000L, 0, "SSB"},
+  { 3500000L,  3535000L, 1, "CW"},
+  { 3535000L,  3600000L, 1, "Digital"},
+  { 3600000L,  3800000L, 1, "SSB"},
+  { 7000000L,  7040000L, 2, "CW"},
+  { 7040000L,  7060000L, 2, "Digital"},
+  { 7060000L,  7300000L, 2, "SSB"},
+  {10100000L, 10150000L, 3, "CW/Digital"},
+  {14000000L, 14070000L, 4, "CW"},
+  {14070000L, 14112000L, 4, "Digital"},
+  {14112000L, 14350000L, 4, "SSB"},
+  {18068000L, 18110000L, 5, "CW/Digital"},
+  {18110000L, 18168000L, 5, "SSB"},
+  {21000000L, 21070000L, 6, "CW"},
+  {21070000L, 21150000L, 6, "Digital"},
+  {21150000L, 21450000L, 6, "SSB"},
+  {24890000L, 24930000L, 7, "CW/Digital"},
+  {24930000L, 24990000L, 7, "SSB"},
+  {28000000L, 28070000L, 8, "CW"},
+  {28070000L, 28300000L, 8, "Digital"},
+  {28300000L, 29700000L, 8, "SSB/FM"},
+  {50000000L, 50100000L, 9, "CW"},
+  {50100000L, 54000000L, 9, "SSB/FM"},
+};
+
+#define NumBands      ((int) ALEN(bands))
+#define NumSegments   ((int) ALEN(segments))
+
+//----------------------------------------
+// Compile time checks of the band plan tables.
+//----------------------------------------
+
+constexpr bool bands_sorted(const Band *b, int n)
+{
+  return (n < 1) || ((b[0].lo < b[0].hi) &&
+                     ((n < 2) || (b[0].hi <= b[1].lo)) &&
+                     bands_sorted(b + 1, n - 1));
+}
+
+constexpr bool segments_sorted(const BandSegment *s, int n)
+{
+  return (n < 1) || ((s[0].lo < s[0].hi) &&
+                     (s[0].band >= 0) && (s[0].band < NumBands) &&
+                     (bands[s[0].band].lo <= s[0].lo) &&
+                     (s[0].hi <= bands[s[0].band].hi) &&
+                     ((n < 2) || (s[0].hi <= s[1].lo)) &&
+                     segments_sorted(s + 1, n - 1));
+}
+
+static_assert(bands_sorted(bands, NumBands), "band table is not sorted");
+static_assert(segments_sorted(segments, NumSegments), "band segment table is not sorted");
+
+// current band state, -1 means out of band
+static int band_seg = -1;             // index of current segment
+static bool band_edge = false;        // 'true' if near a band edge
+static bool band_dirty = true;        // 'true' if indicator must be redrawn
+
+//----------------------------------------
+// Find the segment containing a frequency.
+//     freq  the frequency to look up
+// Returns the segment index, or -1 if not in any band.
+//----------------------------------------
+
+static int band_lookup(Frequency freq)
+{
+  // most retunes stay in the current segment
+  if ((band_seg >= 0) && (segments[band_seg].lo <= freq) && (freq < segments[band_seg].hi))
+    return band_seg;
+
+  int lo = 0;
+  int hi = NumSegments - 1;
+
+  while (lo <= hi)
+  {
+    int mid = (lo + hi) / 2;
+
+    if (freq < segments[mid].lo)
+      hi = mid - 1;
+    else if (freq >= segments[mid].hi)
+      lo = mid + 1;
+    else
+      return mid;
+  }
+
+  return -1;
+}
+
+//----------------------------------------
+// Update the band state for a new frequency.
+//     freq  the new frequency
+// Returns 'true' if the band indicator needs to be redrawn.
+//
+// Called on the retune path, doesn't draw anything.
+//----------------------------------------
+
+bool band_check(Frequency freq)
+{
+  int seg = band_lookup(freq);
+  bool edge = false;
+
+  if (seg >= 0)
+  {
+    const Band *band = &bands[segments[seg].band];
+
+    edge = (freq < band->lo + BAND_EDGE_MARGIN) || (freq + BAND_EDGE_MARGIN >= band->hi);
+  }
+
+  if ((seg != band_seg) || (edge != band_edge))
+  {
+    band_seg = seg;
+    band_edge = edge;
+    band_dirty = true;
+  }
+
+  return band_dirty;
+}
+
+//----------------------------------------
+// Draw the band indicator below the frequency display.
+//     force  if 'true' draw even if nothing changed
+//----------------------------------------
+
+void band_draw(bool force)
+{
+  if (!band_dirty && !force)
+    return;
+
+  bool warn = (band_seg < 0) || band_edge;
+
+  tft.fillRect(0, BAND_IND_Y, tft.width(), BAND_IND_H, (warn) ? BAND_IND_WARN_BG : SCREEN_BG2);
+  tft.setFont(FONT_MENUITEM);
+  tft.setTextColor(BAND_IND_FG);
+  tft.setCursor(BAND_IND_X, BAND_IND_Y + BAND_IND_H - 8);
+
+  if (band_seg < 0)
+  {
+    tft.print("Out of band");
+  }
+  else
+  {
+    const BandSegment *seg = &segments[band_seg];
+
+    tft.printf("%s  %s%s", bands[seg->band].name, seg->mode, (band_edge) ? "  EDGE" : "");
+  }
+
+  band_dirty = false;
+}
+
+//----------------------------------------
+// Accessors for the current band state.
+// band_current() and band_segment() return NULL if out of band.
+//----------------------------------------
+
+const Band *band_current(void)
+{
+  return (band_seg < 0) ? NULL : &bands[segments[band_seg].band];
+}
+
+const BandSegment *band_segment(void)
+{
+  return (band_seg < 0) ? NULL : &segments[band_seg];
+}
+
+bool band_at_edge(void)
+{
+  return band_edge;
+}
@@ -0,0 +1,49 @@
+#ifndef BANDPLAN_H
+#define BANDPLAN_H
+
+////////////////////////////////////////////////////////////////////////////////
+// The amateur band plan for PixelVFO.
+//
+// The band plan is a sorted table of band segments held in flash.  Lookup is
+// a binary search done on the retune path, the band indicator under the
+// frequency display is only redrawn when the band, segment or band edge
+// warning changes.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+#include "PixelVFO.h"
+
+// warn when this close to a band edge (Hz)
+#define BAND_EDGE_MARGIN    3000
+
+// position of the band indicator below the frequency display
+#define BAND_IND_X          5
+#define BAND_IND_Y          (DEPTH_FREQ_DISPLAY + 6)
+#define BAND_IND_H          30
+#define BAND_IND_FG         ILI9341_WHITE
+#define BAND_IND_WARN_BG    ILI9341_RED
+
+// an amateur band
+struct Band
+{
+  Frequency lo;               // lowest frequency in band
+  Frequency hi;               // one past highest frequency in band
+  const char *name;           // band name, eg, "20m"
+};
+
+// one segment of a band
+struct BandSegment
+{
+  Frequency lo;               // lowest frequency in segment
+  Frequency hi;               // one past highest frequency in segment
+  int band;                   // index into band table
+  const char *mode;           // mode hint, eg, "SSB"
+};
+
+bool band_check(Frequency freq);
+void band_draw(bool force);
+const Band *band_current(void);
+const BandSegment *band_segment(void);
+bool band_at_edge(void);
+
+#endif
@@ -0,0 +1,162 @@
+////////////////////////////////////////////////////////////////////////////////
+// Fast boot and last-state restore for PixelVFO.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "PixelVFO.h"
+#include "boot.h"
+#include "eeprom.h"
+#include "dds.h"
+#include "calibrate.h"
+#include "scan.h"
+#include "sweep.h"
+#include "console.h"
+
+unsigned long boot_time = 0;
+
+static bool boot_pending = false;       // 'true' until boot_finish() has run
+static VFOSnapshot boot_saved;          // state as last saved
+static VFOSnapshot boot_changed;        // state when change first seen
+static unsigned long boot_change_time;  // millis() of that change
+static bool boot_dirty = false;         // 'true' if waiting to save
+
+//----------------------------------------
+// Fill in a snapshot record from the current state.
+//     snap  address of record to fill in
+//----------------------------------------
+
+static void boot_snapshot(VFOSnapshot *snap)
+{
+  memset(snap, 0, sizeof(*snap));
+
+  for (int i = 0; i < 2; ++i)
+  {
+    snap->freq[i] = vfo_reg[i].freq;
+    snap->digit[i] = vfo_reg[i].digit;
+  }
+
+  // the active register is only updated from the working copy on a swap
+  snap->freq[vfo_active] = frequency;
+  snap->digit[vfo_active] = freq_digit_select;
+
+  snap->active = vfo_active;
+  snap->split = vfo_split;
+  snap->online = (vfo_state == VFO_Online);
+  snap->scan_dwell = scan_dwell;
+  snap->sweep_start = sweep_start_freq;
+  snap->sweep_stop = sweep_stop_freq;
+  snap->sweep_step = sweep_step_freq;
+  snap->sweep_dwell = sweep_dwell;
+}
+
+//----------------------------------------
+// Set the VFO state from the snapshot, or to the defaults if none.
+// Tuning words are not calculated here, see boot_finish().
+//----------------------------------------
+
+void boot_restore(void)
+{
+  VFOSnapshot snap;
+
+  if (!snapshot_get(&snap) || (snap.active > VFO_B))
+  {
+    memset(&snap, 0, sizeof(snap));
+    snap.freq[VFO_A] = snap.freq[VFO_B] = BOOT_DEFAULT_FREQ;
+    snap.scan_dwell = scan_dwell;
+    snap.sweep_start = sweep_start_freq;
+    snap.sweep_stop = sweep_stop_freq;
+    snap.sweep_step = sweep_step_freq;
+    snap.sweep_dwell = sweep_dwell;
+  }
+
+  for (int i = 0; i < 2; ++i)
+  {
+    VFORegister *reg = &vfo_reg[i];
+
+    reg->freq = (snap.freq[i] <= VFO_MAX_FREQ) ? snap.freq[i] : BOOT_DEFAULT_FREQ;
+    reg->digit = ((snap.digit[i] >= 0) && (snap.digit[i] < NUM_F_CHAR)) ? snap.digit[i] : 0;
+    reg->word = 0;
+    freq_to_buff(reg->display, reg->freq);
+  }
+
+  vfo_active = snap.active;
+  vfo_split = snap.split;
+  vfo_state = (snap.online) ? VFO_Online : VFO_Standby;
+  scan_dwell = snap.scan_dwell;
+  sweep_start_freq = snap.sweep_start;
+  sweep_stop_freq = snap.sweep_stop;
+  sweep_step_freq = snap.sweep_step;
+  sweep_dwell = snap.sweep_dwell;
+
+  // the active register is the working copy
+  frequency = vfo_reg[vfo_active].freq;
+  freq_digit_select = vfo_reg[vfo_active].digit;
+  memcpy(freq_display, vfo_reg[vfo_active].display, sizeof(freq_display));
+
+  boot_snapshot(&boot_saved);
+  DEBUG("boot_restore: VFO %c at %ldHz, %s\n", 'A' + vfo_active, frequency,
+        (vfo_state == VFO_Online) ? "online" : "standby");
+}
+
+//----------------------------------------
+// Note the first frame has been drawn.
+//----------------------------------------
+
+void boot_ready(void)
+{
+  boot_time = micros();
+  boot_pending = true;
+}
+
+//----------------------------------------
+// Do the boot work deferred until after the first frame.
+// Does nothing after the first call.
+//----------------------------------------
+
+void boot_finish(void)
+{
+  if (!boot_pending)
+    return;
+  boot_pending = false;
+
+  cal_init();
+
+  for (int i = 0; i < 2; ++i)
+    vfo_reg[i].word = dds_word(vfo_reg[i].freq);
+  vfo_retune();
+
+  console.printf("PixelVFO booted in %lums\n", boot_time / 1000);
+}
+
+//----------------------------------------
+// Save the state once it has stopped changing.
+//----------------------------------------
+
+void boot_poll(void)
+{
+  VFOSnapshot snap;
+
+  boot_snapshot(&snap);
+
+  if (memcmp(&snap, &boot_saved, sizeof(snap)) == 0)
+  {
+    boot_dirty = false;       // changed back before being saved
+    return;
+  }
+
+  if (!boot_dirty || (memcmp(&snap, &boot_changed, sizeof(snap)) != 0))
+  {
+    // new change, restart the delay
+    boot_changed = snap;
+    boot_change_time = millis();
+    boot_dirty = true;
+    return;
+  }
+
+  if (millis() - boot_change_time >= BOOT_SAVE_DELAY)
+  {
+    DEBUG("boot_poll: saving state\n");
+    snapshot_put(&snap);
+    boot_saved = snap;
+    boot_dirty = false;
+  }
+}
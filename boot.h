@@ -0,0 +1,35 @@
+#ifndef BOOT_H
+#define BOOT_H
+
+////////////////////////////////////////////////////////////////////////////////
+// Fast boot and last-state restore for PixelVFO.
+//
+// setup() calls boot_restore() to load the VFO registers, active VFO,
+// split, online state and scan/sweep settings from the EEPROM snapshot.
+// It then paints the first screen and calls boot_ready().  Work not
+// needed for the first frame is left to boot_finish(), run once from
+// loop(): the calibration table, the DDS tuning words and loading the
+// DDS.
+//
+// boot_poll(), from loop(), saves the snapshot once the state has been
+// unchanged for BOOT_SAVE_DELAY, so a burst of tuning is one EEPROM write.
+// An EEPROM restore calls boot_restore() again, see backup.h, so the state
+// boot_poll() compares with is the restored one.
+//
+// The time from reset to the first touch-ready frame is printed once
+// booted and sent with the "ZB;" CAT command as "ZBnnnnnnnn;" (us).
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+
+#define BOOT_SAVE_DELAY     3000    // ms the state must be stable before saving
+#define BOOT_DEFAULT_FREQ   1000000L
+
+extern unsigned long boot_time;     // reset to first frame (microseconds)
+
+void boot_restore(void);
+void boot_ready(void);
+void boot_finish(void);
+void boot_poll(void);
+
+#endif
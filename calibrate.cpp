@@ -0,0 +1,177 @@
+////////////////////////////////////////////////////////////////////////////////
+// Calibration of the DDS-60 output against a reference.
+//
+// FTM2 counts the divided DDS output.  Its 16 bit counter is extended in
+// software by counting overflows, and each reference edge captures the
+// extended count.  The first edge after the start of a gate is the start
+// time, CAL_GATE_SECONDS edges later is the end time.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "calibrate.h"
+#include "eeprom.h"
+
+// the calibration points, point 0 isn't measured and copies point 1
+const Frequency cal_points[CAL_NUM_POINTS] =
+{
+  0, 1000000L, 5000000L, 10000000L, 20000000L, 30000000L, 45000000L, 60000000L,
+};
+
+// measured error at each point, parts per billion
+int32_t cal_ppb[CAL_NUM_POINTS];
+
+// gate state shared with the interrupt handler
+static volatile uint32_t cal_overflows = 0;   // FTM2 counter overflows
+static volatile uint32_t cal_start = 0;       // extended count at gate start
+static volatile uint32_t cal_end = 0;         // extended count at gate end
+static volatile int cal_edges = -1;           // reference edges seen in gate
+
+#ifndef CAL_SIMULATE
+//----------------------------------------
+// FTM2 interrupt handler.
+// Handles counter overflow and reference edge capture.
+//----------------------------------------
+
+void ftm2_isr(void)
+{
+  uint32_t sc = FTM2_SC;
+  uint32_t csc = FTM2_C1SC;
+  uint32_t overflows = cal_overflows;
+
+  if (csc & FTM_CSC_CHF)
+  {
+    uint32_t capture = FTM2_C1V;
+
+    FTM2_C1SC = csc & ~FTM_CSC_CHF;
+
+    // an overflow not yet counted happened before a small capture value
+    if ((sc & FTM_SC_TOF) && (capture < 0x8000))
+      ++overflows;
+
+    uint32_t count = (overflows << 16) | capture;
+
+    if (cal_edges == 0)
+      cal_start = count;
+    if (cal_edges == CAL_GATE_SECONDS)
+      cal_end = count;
+    if ((cal_edges >= 0) && (cal_edges <= CAL_GATE_SECONDS))
+      ++cal_edges;      // CAL_GATE_SECONDS+1 means gate is done
+  }
+
+  if (sc & FTM_SC_TOF)
+  {
+    FTM2_SC = sc & ~FTM_SC_TOF;
+    ++cal_overflows;
+  }
+}
+#endif
+
+//----------------------------------------
+// Load the saved calibration and apply it to the DDS.
+// With no saved calibration the DDS is left uncorrected.
+//----------------------------------------
+
+void cal_init(void)
+{
+  memset(cal_ppb, 0, sizeof(cal_ppb));
+  calibration_get(cal_ppb, CAL_NUM_POINTS);
+  cal_apply();
+}
+
+//----------------------------------------
+// Build the DDS tuning word table from 'cal_ppb'.
+//----------------------------------------
+
+void cal_apply(void)
+{
+  cal_ppb[0] = cal_ppb[1];
+  dds_set_correction(cal_points, cal_ppb, CAL_NUM_POINTS);
+}
+
+//----------------------------------------
+// Save 'cal_ppb' to EEPROM.
+//----------------------------------------
+
+void cal_save(void)
+{
+  calibration_put(cal_ppb, CAL_NUM_POINTS);
+}
+
+//----------------------------------------
+// Set the DDS to a frequency and start a measurement gate.
+//     freq  the frequency to measure
+// The DDS table should be uncorrected so the raw error is measured.
+//----------------------------------------
+
+unsigned long cal_gate_time;            // millis() at gate start
+
+void cal_gate_start(Frequency freq)
+{
+  dds_load_word(dds_word(freq));
+  cal_gate_time = millis();
+
+#ifdef CAL_SIMULATE
+  cal_start = 0;
+  cal_end = (uint32_t) ((((int64_t) freq * (1000000000LL + CAL_SIMULATE)) / 1000000000LL)
+                        * CAL_GATE_SECONDS / CAL_PRESCALE);
+  cal_edges = 0;
+#else
+  NVIC_DISABLE_IRQ(IRQ_FTM2);
+
+  // route the pins to FTM2
+  SIM_SCGC3 |= SIM_SCGC3_FTM2;
+  SIM_SOPT4 &= ~SIM_SOPT4_FTM2CLKSEL;           // FTM2 clocked from FTM_CLKIN0
+  CORE_PIN0_CONFIG = PORT_PCR_MUX(4);
+  CORE_PIN25_CONFIG = PORT_PCR_MUX(3);
+
+  // free running 16 bit counter, capture on rising reference edge
+  FTM2_SC = 0;
+  FTM2_CNT = 0;
+  FTM2_MOD = 0xFFFF;
+  FTM2_C1SC = FTM_CSC_ELSA | FTM_CSC_CHIE;
+  cal_overflows = 0;
+  cal_edges = 0;
+  FTM2_SC = FTM_SC_CLKS(3) | FTM_SC_PS(0) | FTM_SC_TOIE;
+
+  NVIC_ENABLE_IRQ(IRQ_FTM2);
+#endif
+}
+
+//----------------------------------------
+// Returns 'true' if the current gate is finished.
+//----------------------------------------
+
+bool cal_gate_done(void)
+{
+#ifdef CAL_SIMULATE
+  return (millis() - cal_gate_time) >= CAL_GATE_SECONDS * 1000UL;
+#else
+  return cal_edges > CAL_GATE_SECONDS;
+#endif
+}
+
+//----------------------------------------
+// Stop the frequency counter.
+//----------------------------------------
+
+void cal_gate_stop(void)
+{
+#ifndef CAL_SIMULATE
+  NVIC_DISABLE_IRQ(IRQ_FTM2);
+  FTM2_SC = 0;
+#endif
+  cal_edges = -1;
+}
+
+//----------------------------------------
+// Get the error measured by the last gate.
+//     freq  the frequency the DDS was set to
+// Returns the error in parts per billion.
+//----------------------------------------
+
+int32_t cal_gate_error(Frequency freq)
+{
+  int64_t measured = (int64_t) (cal_end - cal_start) * CAL_PRESCALE * 1000 / CAL_GATE_SECONDS;
+  int64_t expected = (int64_t) freq * 1000;
+
+  return (int32_t) ((measured - expected) * 1000000000LL / expected);
+}
@@ -0,0 +1,45 @@
+#ifndef CALIBRATE_H
+#define CALIBRATE_H
+
+////////////////////////////////////////////////////////////////////////////////
+// Calibration of the DDS-60 output against a reference.
+//
+// The DDS output, divided by an external CAL_PRESCALE divider, clocks
+// FTM2 through FTM_CLKIN0 (pin 0).  A 1PPS reference (eg, from a GPS) on
+// pin 25 captures the FTM2 count, so the DDS cycles in a gate of whole
+// reference seconds can be counted.
+//
+// The error measured at each calibration point is saved in EEPROM and
+// turned into the DDS tuning word table, see dds_set_correction().
+//
+// Define CAL_SIMULATE to replace the counter with a simulated source
+// having a clock error of CAL_SIMULATE parts per billion.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+#include "PixelVFO.h"
+#include "dds.h"
+
+// pins used by the frequency counter
+#define CAL_CLOCK_PIN       0       // FTM_CLKIN0, divided DDS output
+#define CAL_REF_PIN         25      // FTM2_CH1, 1PPS reference
+
+#define CAL_PRESCALE        8       // external divider on DDS output
+#define CAL_GATE_SECONDS    4       // length of a measurement gate
+#define CAL_TIMEOUT         ((CAL_GATE_SECONDS + 3) * 1000) // milliseconds
+
+#define CAL_NUM_POINTS      8       // number of points in calibration table
+
+extern const Frequency cal_points[CAL_NUM_POINTS];
+extern int32_t cal_ppb[CAL_NUM_POINTS];
+extern unsigned long cal_gate_time;
+
+void cal_init(void);
+void cal_apply(void);
+void cal_save(void);
+void cal_gate_start(Frequency freq);
+bool cal_gate_done(void);
+void cal_gate_stop(void);
+int32_t cal_gate_error(Frequency freq);
+
+#endif
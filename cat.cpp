@@ -0,0 +1,329 @@
+////////////////////////////////////////////////////////////////////////////////
+// A CAT (computer aided transceiver) control engine for PixelVFO.
+//
+// Bytes are collected into a command buffer until a ';' is seen, then the
+// command is executed.  Frequency changes go through vfo_set_freq(), the
+// same path the touchscreen uses.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "cat.h"
+#include "console.h"
+#include "eeprom.h"
+#include "mirror.h"
+#include "profile.h"
+#include "idle.h"
+#include "boot.h"
+#include "fill.h"
+#include "spibus.h"
+#include "backup.h"
+#include "render.h"
+#include "snapshot.h"
+#include "monitor.h"
+
+static char cat_buff[CAT_MAX_COMMAND];    // command being collected
+static int cat_len = 0;                   // number of chars in 'cat_buff'
+static bool cat_overflow = false;         // discard until next ';'
+
+//----------------------------------------
+// Send a reply to the host.
+//     reply  the reply string
+// The reply is queued in the console, between any mirror messages.
+//----------------------------------------
+
+static void cat_reply(const char *reply)
+{
+  console.print(reply);
+}
+
+//----------------------------------------
+// Parse a fixed number of decimal digits.
+//     str     address of first digit
+//     num     number of digits to parse
+//     result  reference to cell to receive value
+// Returns 'false' if a character isn't a digit.
+//----------------------------------------
+
+static bool cat_number(const char *str, int num, unsigned long &result)
+{
+  result = 0;
+
+  for (int i = 0; i < num; ++i)
+  {
+    if (!isdigit(str[i]))
+      return false;
+    result = result * 10 + (str[i] - '0');
+  }
+
+  return true;
+}
+
+//----------------------------------------
+// Handle a frequency get/set command for one VFO register.
+//     reg  index of the register
+//     cmd  the command, without the ';'
+//     len  length of 'cmd'
+// Returns 'false' if the command was bad.
+//----------------------------------------
+
+static bool cat_freq(int reg, const char *cmd, int len)
+{
+  char reply[CAT_MAX_COMMAND];
+
+  if (len == 2)
+  {
+    Frequency freq = (reg == vfo_active) ? frequency : vfo_reg[reg].freq;
+
+    sprintf(reply, "%.2s%011ld;", cmd, freq);
+    cat_reply(reply);
+    return true;
+  }
+
+  unsigned long freq;
+
+  if ((len != 2 + CAT_FREQ_DIGITS) || !cat_number(cmd + 2, CAT_FREQ_DIGITS, freq))
+    return false;
+  if (freq > VFO_MAX_FREQ)
+    return false;
+
+  vfo_set_freq(reg, freq);
+  return true;
+}
+
+//----------------------------------------
+// Execute one complete command.
+//     cmd  the command, without the ';'
+//     len  length of 'cmd'
+// Returns 'false' if the command was bad.
+//----------------------------------------
+
+static bool cat_execute(const char *cmd, int len)
+{
+  char reply[CAT_MAX_COMMAND];
+  unsigned long num;
+
+  if (len < 2)
+    return false;
+
+  switch ((cmd[0] << 8) | cmd[1])
+  {
+    case ('F' << 8) | 'A':
+      return cat_freq(VFO_A, cmd, len);
+
+    case ('F' << 8) | 'B':
+      return cat_freq(VFO_B, cmd, len);
+
+    case ('F' << 8) | 'R':
+      if (len == 2)
+      {
+        sprintf(reply, "FR%d;", vfo_active);
+        cat_reply(reply);
+        return true;
+      }
+      if ((len != 3) || !cat_number(cmd + 2, 1, num) || (num > 1))
+        return false;
+      vfo_select(num);
+      return true;
+
+    case ('F' << 8) | 'T':
+      if (len == 2)
+      {
+        sprintf(reply, "FT%d;", (vfo_split) ? 1 : 0);
+        cat_reply(reply);
+        return true;
+      }
+      if ((len != 3) || !cat_number(cmd + 2, 1, num) || (num > 1))
+        return false;
+      vfo_split = (num == 1);
+      render_mark(RD_AB);
+      return true;
+
+    case ('M' << 8) | 'R':
+      if ((len != 5) || !cat_number(cmd + 2, 3, num) || (num >= NumSaveSlots))
+        return false;
+      {
+        Frequency freq;
+        SelOffset offset;
+
+        slot_get(num, freq, offset);
+        sprintf(reply, "MR%03lu%011ld;", num, freq);
+        cat_reply(reply);
+      }
+      return true;
+
+    case ('M' << 8) | 'W':
+      if ((len != 5 + CAT_FREQ_DIGITS) || !cat_number(cmd + 2, 3, num) || (num >= NumSaveSlots))
+        return false;
+      {
+        unsigned long freq;
+
+        if (!cat_number(cmd + 5, CAT_FREQ_DIGITS, freq) || (freq > VFO_MAX_FREQ))
+          return false;
+        slot_put(num, freq, 0);
+      }
+      return true;
+
+    case ('I' << 8) | 'D':
+      cat_reply(CAT_ID);
+      return true;
+
+    case ('A' << 8) | 'I':
+      if (len == 2)
+        cat_reply("AI0;");
+      return true;      // we never send auto information
+
+    case ('Z' << 8) | 'M':
+      if ((len != 3) || !cat_number(cmd + 2, 1, num) || (num > 1))
+        return false;
+      if (num)
+        mirror_start();
+      else
+        mirror_stop();
+      return true;
+
+    case ('Z' << 8) | 'L':
+      if (len == 2)
+        latency_report();
+      else if ((len == 3) && (cmd[2] == '0'))
+        latency_reset();
+      else
+        return false;
+      return true;
+
+    case ('Z' << 8) | 'I':
+      if (len == 2)
+        idle_report();
+      else if ((len == 3) && (cmd[2] == '0'))
+        idle_reset();
+      else
+        return false;
+      return true;
+
+    case ('Z' << 8) | 'B':
+      if (len != 2)
+        return false;
+      sprintf(reply, "ZB%08lu;", boot_time);
+      cat_reply(reply);
+      return true;
+
+    case ('Z' << 8) | 'F':
+      if (len == 2)
+        fill_report();
+      else if ((len == 3) && (cmd[2] == '0'))
+        fill_reset();
+      else
+        return false;
+      return true;
+
+    case ('Z' << 8) | 'S':
+      if (len == 2)
+        spi_report();
+      else if ((len == 3) && (cmd[2] == '0'))
+        spi_reset();
+      else
+        return false;
+      return true;
+
+    case ('Z' << 8) | 'R':
+      if (!backup_read(cmd, len, reply))
+        return false;
+      cat_reply(reply);
+      return true;
+
+    case ('Z' << 8) | 'W':
+      if (!backup_write(cmd, len, reply))
+        return false;
+      cat_reply(reply);
+      return true;
+
+    case ('Z' << 8) | 'C':
+      {
+        int written;
+
+        if ((len != 2) || ((written = backup_commit()) < 0))
+          return false;
+        sprintf(reply, "ZC%04X;", written);
+        cat_reply(reply);
+      }
+      return true;
+
+    case ('Z' << 8) | 'T':
+      if (len == 2)
+      {
+        sprintf(reply, "ZT%03d;", snapshot_count());
+        cat_reply(reply);
+        return true;
+      }
+      if ((len != 5) || !cat_number(cmd + 2, 3, num))
+        return false;
+      return snapshot_take(num);
+
+    case ('Z' << 8) | 'V':
+      if (len != 2)
+        return false;
+      monitor_report();
+      return true;
+
+#ifdef PROFILE_ENABLE
+    case ('Z' << 8) | 'P':
+      if (len == 2)
+        profile_report();
+      else if ((len == 3) && (cmd[2] == '0'))
+        profile_reset();
+      else
+        return false;
+      return true;
+#endif
+
+    case ('P' << 8) | 'S':
+      if (len == 2)
+        cat_reply("PS1;");
+      return true;
+  }
+
+  return false;
+}
+
+//----------------------------------------
+// Handle waiting CAT input.
+// Returns 'true' if a command was executed.
+//
+// At most CAT_MAX_POLL bytes are handled in one call, so a flood of
+// commands can't stall touch handling.
+//----------------------------------------
+
+bool cat_poll(void)
+{
+  bool result = false;
+
+  for (int i = 0; i < CAT_MAX_POLL; ++i)
+  {
+    int ch = CAT_SERIAL.read();
+
+    if (ch < 0)
+      break;        // no more input
+
+    if (ch == ';')
+    {
+      if (cat_overflow || !cat_execute(cat_buff, cat_len))
+        cat_reply("?;");
+      else
+        result = true;
+      cat_len = 0;
+      cat_overflow = false;
+    }
+    else if ((ch == '\r') || (ch == '\n'))
+    {
+      continue;     // some programs add line ends
+    }
+    else if (cat_len < CAT_MAX_COMMAND - 1)
+    {
+      cat_buff[cat_len++] = toupper(ch);
+    }
+    else
+    {
+      cat_overflow = true;
+    }
+  }
+
+  return result;
+}
@@ -0,0 +1,45 @@
+#ifndef CAT_H
+#define CAT_H
+
+////////////////////////////////////////////////////////////////////////////////
+// A CAT (computer aided transceiver) control engine for PixelVFO.
+//
+// Implements a subset of the Kenwood CAT protocol over the USB serial port.
+// Commands are ASCII, terminated by ';'.  Input is parsed incrementally
+// from cat_poll(), which never waits for input or for a whole command.
+//
+//     FA;  FAnnnnnnnnnnn;      get/set VFO A frequency (11 digits, Hz)
+//     FB;  FBnnnnnnnnnnn;      get/set VFO B frequency
+//     FR;  FRn;                get/set active VFO (0=A, 1=B)
+//     FT;  FTn;                get/set split (0=off, 1=on, transmit on B)
+//     MRnnn;                   read slot nnn, reply MRnnnfffffffffff;
+//     MWnnnfffffffffff;        write frequency to slot nnn
+//     ID;  AI;  AIn;  PS;      identification/compatibility replies
+//     ZMn;                     screen mirror off/on (0=off, 1=on)
+//     ZP;  ZP0;                send/clear profile records (see profile.cpp)
+//     ZL;  ZL0;                send/clear latency histograms (see latency.h)
+//     ZI;  ZI0;                send/clear idle statistics (see idle.h)
+//     ZB;                      boot time, reply ZBnnnnnnnn; (microseconds)
+//     ZF;  ZF0;                send/clear fill statistics (see fill.cpp)
+//     ZS;  ZS0;                send/clear SPI bus statistics (see spibus.h)
+//     ZR...;  ZW...;  ZC;      EEPROM backup and restore (see backup.h)
+//     ZT;  ZTnnn;              snapshot count/draw snapshot nnn (see snapshot.h)
+//     ZV;                      send monitor statistics (see monitor.h)
+//
+// Unknown or bad commands get the reply "?;".
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+#include "PixelVFO.h"
+
+// serial port CAT commands are read from, replies go through the console
+#define CAT_SERIAL          Serial
+
+#define CAT_MAX_COMMAND     48      // longest command, including ';'
+#define CAT_MAX_POLL        64      // most bytes handled in one cat_poll()
+#define CAT_FREQ_DIGITS     11      // digits in a CAT frequency
+#define CAT_ID              "ID020;"    // we look like a TS-480
+
+bool cat_poll(void);
+
+#endif
@@ -0,0 +1,177 @@
+////////////////////////////////////////////////////////////////////////////////
+// The serial console, the only writer to the USB serial port.
+//
+// The ring buffer holds whole messages from 'console_tail' up to
+// 'console_head'.  A message being written goes in after 'console_head'
+// and only becomes part of the stream at console_end(), so a message that
+// doesn't fit can be dropped even if the buffer was drained while waiting.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "console.h"
+
+Console console;
+
+static uint8_t console_buff[CONSOLE_BUFF_SIZE];
+static int console_head = 0;            // end of the last whole message
+static int console_tail = 0;            // next byte sent from here
+static int console_fill;                // next byte of open message goes here
+static bool console_fail;               // open message didn't fit
+static uint32_t console_wait;           // ms the open message may wait
+static unsigned long console_start;     // millis() when the message started
+static bool console_stalled = false;    // 'true' if the host stopped reading
+static unsigned long console_drops = 0; // number of text writes dropped
+
+//----------------------------------------
+// Start a message.
+//     wait_ms  longest time to wait for room, 0 to drop at once if full
+//----------------------------------------
+
+void console_begin(uint32_t wait_ms)
+{
+  console_fill = console_head;
+  console_fail = false;
+  console_wait = wait_ms;
+  console_start = millis();
+}
+
+//----------------------------------------
+// Add one byte to the message.
+//     b  the byte
+//
+// If the buffer is full, sends to the host while it is taking data,
+// up to the message's wait time.
+//----------------------------------------
+
+void console_byte(uint8_t b)
+{
+  if (console_fail)
+    return;
+
+  int next = (console_fill + 1) % CONSOLE_BUFF_SIZE;
+
+  while (next == console_tail)
+  {
+    if (console_tail == console_head)
+      break;            // the message alone fills the buffer
+    if (console_stalled || (millis() - console_start >= console_wait))
+    {
+      if (console_wait > 0)
+        console_stalled = true;
+      break;
+    }
+    console_drain();
+    yield();
+  }
+
+  if (next == console_tail)
+  {
+    console_fail = true;
+    return;
+  }
+
+  console_buff[console_fill] = b;
+  console_fill = next;
+}
+
+//----------------------------------------
+// End the message, it is sent after the messages before it.
+// Returns 'false' if it didn't fit and was dropped.
+//----------------------------------------
+
+bool console_end(void)
+{
+  if (console_fail)
+    return false;
+
+  console_head = console_fill;
+  return true;
+}
+
+//----------------------------------------
+// Send buffered messages to the host.
+//
+// Only sends what the serial port will take without waiting.
+//----------------------------------------
+
+void console_drain(void)
+{
+  int space = CONSOLE_SERIAL.availableForWrite();
+
+  while ((space > 0) && (console_tail != console_head))
+  {
+    int len = ((console_head > console_tail) ? console_head : CONSOLE_BUFF_SIZE) - console_tail;
+
+    if (len > space)
+      len = space;
+    len = CONSOLE_SERIAL.write(console_buff + console_tail, len);
+    if (len <= 0)
+      break;
+    console_tail = (console_tail + len) % CONSOLE_BUFF_SIZE;
+    console_stalled = false;
+    space -= len;
+  }
+}
+
+//----------------------------------------
+// Returns the number of bytes waiting to be sent.
+//----------------------------------------
+
+int console_pending(void)
+{
+  return (console_head - console_tail + CONSOLE_BUFF_SIZE) % CONSOLE_BUFF_SIZE;
+}
+
+//----------------------------------------
+// Returns the number of text writes dropped because the host wasn't reading.
+//----------------------------------------
+
+unsigned long console_dropped(void)
+{
+  return console_drops;
+}
+
+//----------------------------------------
+// Print output, each write is one message.
+//----------------------------------------
+
+size_t Console::write(uint8_t b)
+{
+  return write(&b, 1);
+}
+
+size_t Console::write(const uint8_t *buff, size_t len)
+{
+  console_begin(CONSOLE_WAIT_MS);
+  for (size_t i = 0; i < len; ++i)
+    console_byte(buff[i]);
+  if (!console_end())
+  {
+    ++console_drops;
+    return 0;
+  }
+  return len;
+}
+
+//----------------------------------------
+// Returns the room for one message without waiting.
+//----------------------------------------
+
+int Console::availableForWrite(void)
+{
+  return CONSOLE_BUFF_SIZE - 1 - console_pending();
+}
+
+//----------------------------------------
+// Send everything buffered, waiting up to CONSOLE_FLUSH_MS for the host.
+//----------------------------------------
+
+void Console::flush(void)
+{
+  unsigned long start = millis();
+
+  while (console_pending() && (millis() - start < CONSOLE_FLUSH_MS))
+  {
+    console_drain();
+    yield();
+  }
+}
@@ -0,0 +1,54 @@
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+////////////////////////////////////////////////////////////////////////////////
+// The serial console, the only writer to the USB serial port.
+//
+// Everything PixelVFO sends to the host goes through here: CAT replies,
+// reports, dumps, log messages and the screen mirror stream.  It all goes
+// into one ring buffer that console_drain() sends as fast as the port takes
+// it.  Each write is a message, put in whole or not at all, so text can't
+// land in the middle of a mirror message and the host sees both intact.
+//
+// Text is written with the 'console' Print object, eg:
+//
+//     console.printf("ZI%lu;", value);
+//
+// If the buffer is full, a text write drains it and waits up to
+// CONSOLE_WAIT_MS for the host to take enough.  If the host doesn't, the
+// write is dropped and counted, and later writes are dropped at once until
+// the host takes something again.  The mirror builds its messages with
+// console_begin(), console_byte() and console_end() and chooses its own
+// wait, see mirror.h.
+//
+// console_drain() is called by every event loop in pen_touch().  Nothing
+// else writes to the port.  Input is still read from Serial directly.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+
+#define CONSOLE_SERIAL      Serial
+#define CONSOLE_BUFF_SIZE   4096    // size of output ring buffer
+#define CONSOLE_WAIT_MS     100     // longest wait for room for text (ms)
+#define CONSOLE_FLUSH_MS    1000    // longest wait in console_flush() (ms)
+
+class Console : public Print
+{
+  public:
+    size_t write(uint8_t b) override;
+    size_t write(const uint8_t *buff, size_t len) override;
+    int availableForWrite(void) override;
+    void flush(void) override;
+    using Print::write;
+};
+
+extern Console console;
+
+void console_begin(uint32_t wait_ms);
+void console_byte(uint8_t b);
+bool console_end(void);
+void console_drain(void);
+int console_pending(void);
+unsigned long console_dropped(void);
+
+#endif
@@ -0,0 +1,176 @@
+////////////////////////////////////////////////////////////////////////////////
+// Interface to the DDS-60 oscillator card.
+//
+// The load routine is kept small and free of divisions so it can be
+// called from timer interrupt code.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "dds.h"
+
+// one segment of the tuning word table
+// a frequency 'f' in the segment has tuning word:
+//     word + (((f - freq) * slope) >> 32)
+struct DDSSegment
+{
+  Frequency freq;       // frequency at segment start
+  uint32_t word;        // corrected tuning word for 'freq'
+  uint64_t slope;       // tuning word change per Hz, 32.32 fixed point
+};
+
+static DDSSegment dds_seg[DDS_MAX_POINTS];
+static int dds_num_seg = 0;
+
+// frequencies used for the uncorrected table
+static const Frequency dds_nominal_points[] = {0, DDS_REF_CLOCK / 3};
+
+//----------------------------------------
+// Pulse a DDS control pin high then low.
+//----------------------------------------
+
+static inline void dds_pulse(uint8_t pin)
+{
+  digitalWriteFast(pin, HIGH);
+  digitalWriteFast(pin, LOW);
+}
+
+//----------------------------------------
+// Shift one byte out to the DDS, LSB first.
+//----------------------------------------
+
+static inline void dds_byte(uint8_t data)
+{
+  for (int i = 0; i < 8; ++i, data >>= 1)
+  {
+    digitalWriteFast(DDS_DATA, data & 0x01);
+    dds_pulse(DDS_W_CLK);
+  }
+}
+
+//----------------------------------------
+// Load a tuning word and control byte into the DDS and latch it.
+//----------------------------------------
+
+static inline void dds_load(uint32_t word, uint8_t control)
+{
+  dds_byte(word);
+  dds_byte(word >> 8);
+  dds_byte(word >> 16);
+  dds_byte(word >> 24);
+  dds_byte(control);
+  dds_pulse(DDS_FQ_UD);
+}
+
+//----------------------------------------
+// Initialize the DDS pins and put the chip into serial mode.
+// The DDS is left powered down.
+//----------------------------------------
+
+void dds_init(void)
+{
+  pinMode(DDS_DATA, OUTPUT);
+  pinMode(DDS_W_CLK, OUTPUT);
+  pinMode(DDS_FQ_UD, OUTPUT);
+
+  // the DDS-60 hardwires D0-D2 so a W_CLK/FQ_UD pulse selects serial mode
+  dds_pulse(DDS_W_CLK);
+  dds_pulse(DDS_FQ_UD);
+
+  dds_set_correction(dds_nominal_points, NULL, ALEN(dds_nominal_points));
+  dds_standby();
+}
+
+//----------------------------------------
+// Compute the exact tuning word for a frequency and clock error.
+//     freq  the frequency (Hz)
+//     ppb   error of the DDS clock in parts per billion
+// Uses floating point, so only used when building the table.
+//----------------------------------------
+
+static uint32_t dds_exact_word(Frequency freq, int32_t ppb)
+{
+  double clock = (double) DDS_REF_CLOCK * (1.0 + (double) ppb * 1e-9);
+
+  return (uint32_t) ((double) freq * 4294967296.0 / clock + 0.5);
+}
+
+//----------------------------------------
+// Build the tuning word table from calibration data.
+//     points  ascending frequencies of the calibration points
+//     ppb     measured clock error at each point (NULL for no correction)
+//     num     number of points, 2 to DDS_MAX_POINTS
+//
+// Frequencies outside the points use the nearest end segment.
+//----------------------------------------
+
+void dds_set_correction(const Frequency *points, const int32_t *ppb, int num)
+{
+  if (num < 2)
+    abort("dds_set_correction: need at least 2 points");
+  if (num > DDS_MAX_POINTS)
+    num = DDS_MAX_POINTS;
+
+  for (int i = 0; i < num; ++i)
+  {
+    dds_seg[i].freq = points[i];
+    dds_seg[i].word = dds_exact_word(points[i], (ppb) ? ppb[i] : 0);
+  }
+
+  for (int i = 0; i < num - 1; ++i)
+  {
+    uint64_t dword = dds_seg[i+1].word - dds_seg[i].word;
+
+    dds_seg[i].slope = (dword << 32) / (dds_seg[i+1].freq - dds_seg[i].freq);
+  }
+  dds_seg[num-1].slope = dds_seg[num-2].slope;
+
+  dds_num_seg = num;
+}
+
+//----------------------------------------
+// Convert a frequency to an AD9851 tuning word.
+//     freq  the frequency to convert (Hz)
+// Returns the 32 bit tuning word.
+//----------------------------------------
+
+uint32_t dds_word(Frequency freq)
+{
+  const DDSSegment *seg = dds_seg;
+  const DDSSegment *last = &dds_seg[dds_num_seg - 1];
+
+  while ((seg < last) && (freq >= (seg+1)->freq))
+    ++seg;
+
+  return seg->word + (uint32_t) (((uint64_t) (freq - seg->freq) * seg->slope) >> 32);
+}
+
+//----------------------------------------
+// Load a precomputed tuning word into the DDS.
+//     word  the tuning word to load
+// Safe to call from interrupt code.
+//----------------------------------------
+
+void dds_load_word(uint32_t word)
+{
+  dds_load(word, DDS_CTRL_6X);
+}
+
+//----------------------------------------
+// Set the DDS output to the given frequency.
+//     freq  the frequency to generate (Hz)
+//----------------------------------------
+
+void dds_set_freq(Frequency freq)
+{
+  DEBUG("dds_set_freq: freq=%ldHz\n", freq);
+  dds_load_word(dds_word(freq));
+}
+
+//----------------------------------------
+// Turn off the DDS output.
+//----------------------------------------
+
+void dds_standby(void)
+{
+  DEBUG("dds_standby: called\n");
+  dds_load(0, DDS_CTRL_6X | DDS_CTRL_PDOWN);
+}
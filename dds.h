@@ -0,0 +1,41 @@
+#ifndef DDS_H
+#define DDS_H
+
+////////////////////////////////////////////////////////////////////////////////
+// Interface to the DDS-60 oscillator card.
+//
+// The DDS-60 carries an AD9851 chip clocked from a 30MHz oscillator with
+// the internal 6x multiplier enabled.  The chip is loaded serially with a
+// 32 bit tuning word followed by an 8 bit control word.
+//
+// Frequency to tuning word conversion uses a piecewise-linear table built
+// from the calibration data, so a calibrated retune costs the same as an
+// uncalibrated one: a short search, one multiply and one add.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+#include "PixelVFO.h"
+
+// pins used to talk to the DDS-60
+#define DDS_DATA        16
+#define DDS_W_CLK       17
+#define DDS_FQ_UD       18
+
+// the nominal AD9851 system clock (30MHz reference * 6)
+#define DDS_REF_CLOCK   180000000UL
+
+// maximum number of points in the tuning word correction table
+#define DDS_MAX_POINTS  8
+
+// AD9851 control word values
+#define DDS_CTRL_6X     0x01      // enable 6x reference multiplier
+#define DDS_CTRL_PDOWN  0x04      // power down the chip
+
+void dds_init(void);
+void dds_set_correction(const Frequency *points, const int32_t *ppb, int num);
+uint32_t dds_word(Frequency freq);
+void dds_load_word(uint32_t word);
+void dds_set_freq(Frequency freq);
+void dds_standby(void);
+
+#endif
@@ -3,6 +3,8 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "eeprom.h"
+#include "profile.h"
+#include "console.h"
 
 
 //##############################################################################
@@ -10,39 +12,47 @@
 //##############################################################################
 
 // Define the address in EEPROM of various things.
-// The "NEXT_FREE" value is the address of the next free slot address.
-// Ignore "redefine errors" - not very helpful in this case!
+// The "NEXT_FREE" value is the address of the next free slot address, it is
+// undefined before each new definition so the compiler doesn't warn.
 // The idea is that we are free to rearrange objects below with minimum fuss.
 
 // start storing at address 0
+#undef NEXT_FREE
 #define NEXT_FREE   (0)
 
 // address for Frequency 'frequency'
 const int AddressFreq = NEXT_FREE;
+#undef NEXT_FREE
 #define NEXT_FREE   (AddressFreq + sizeof(Frequency))
 
 // address for int 'selected digit'
 const int AddressSelDigit = NEXT_FREE;
+#undef NEXT_FREE
 #define NEXT_FREE   (AddressSelDigit + sizeof(SelOffset))
 
 #if 0
 // address for 'VfoClockOffset' calibration
 const int AddressVfoClockOffset = NEXT_FREE;
+#undef NEXT_FREE
 #define NEXT_FREE   (AddressVfoClockOffset + sizeof(VfoClockOffset))
 
 // address for byte 'contrast'
 const int AddressContrast = NEXT_FREE;
+#undef NEXT_FREE
 #define NEXT_FREE   (AddressContrast + sizeof(LcdContrast))
 
 // address for byte 'brightness'
 const int AddressBrightness = NEXT_FREE;
+#undef NEXT_FREE
 #define NEXT_FREE   (AddressBrightness + sizeof(LcdBrightness))
 
 const int SaveFreqBase = NEXT_FREE;
+#undef NEXT_FREE
 #define NEXT_FREE   (SaveFreqBase + NumSaveSlots * sizeof(Frequency))
 
 //also save the offset for each frequency
 const int SaveOffsetBase = NEXT_FREE;
+#undef NEXT_FREE
 #define NEXT_FREE   (SaveOffsetBase + NumSaveSlots * sizeof(SelOffset);
 #endif 
 
@@ -90,6 +100,7 @@ void restore_from_eeprom(void)
 
 void slot_get(int slot_num, Frequency &freq, SelOffset &offset)
 {
+  PROFILE_ZONE(PZ_SlotGet);
   int freq_address = SaveFreqBase + slot_num * sizeof(Frequency);
   int offset_address = SaveOffsetBase + slot_num * sizeof(SelOffset);
 
@@ -106,6 +117,7 @@ void slot_get(int slot_num, Frequency &freq, SelOffset &offset)
 
 void slot_put(int slot_num, Frequency freq, SelOffset offset)
 {
+  PROFILE_ZONE(PZ_SlotPut);
   DEBUG("slot_put: would store freq %ldHz and offset %d in slot %d\n",
         freq, offset, slot_num);
         
@@ -116,6 +128,47 @@ void slot_put(int slot_num, Frequency freq, SelOffset offset)
   EEPROM.put(offset_address, offset);
 }
 
+// value in CalMarkerAddress if the calibration table is valid
+#define CAL_MARKER    0x43414C31    // "CAL1"
+
+//----------------------------------------
+// Get the calibration table.
+//     ppb  address of array to fill with error values
+//     num  number of values to get
+// Returns 'false' if there is no saved table, 'ppb' is not changed.
+//----------------------------------------
+
+bool calibration_get(int32_t *ppb, int num)
+{
+  uint32_t marker;
+
+  EEPROM.get(CalMarkerAddress, marker);
+  if (marker != CAL_MARKER)
+  {
+    DEBUG("calibration_get: no saved calibration\n");
+    return false;
+  }
+
+  for (int i = 0; i < num; ++i)
+    EEPROM.get(CalTableBase + i * sizeof(int32_t), ppb[i]);
+
+  return true;
+}
+
+//----------------------------------------
+// Save the calibration table.
+//     ppb  address of array of error values
+//     num  number of values to save
+//----------------------------------------
+
+void calibration_put(const int32_t *ppb, int num)
+{
+  for (int i = 0; i < num; ++i)
+    EEPROM.put(CalTableBase + i * sizeof(int32_t), ppb[i]);
+
+  EEPROM.put(CalMarkerAddress, (uint32_t) CAL_MARKER);
+}
+
 #if 0
 //----------------------------------------
 // Print all EEPROM saved data to console.
@@ -139,35 +192,100 @@ void dump_eeprom(void)
   EEPROM.get(AddressHoldClickTime, hold);
   EEPROM.get(AddressDClickTime, dclick);
   
-  Serial.printf(F("=================================================\n"));
-  Serial.printf(F("dump_eeprom: VfoFrequency=%ld\n"), freq);
-  Serial.printf(F("             AddressSelDigit=%d\n"), offset);
-  Serial.printf(F("             VfoClockOffset=%d\n"), clkoffset);
-  Serial.printf(F("             LcdBrightness=%d\n"), brightness);
-  Serial.printf(F("             LcdContrast=%d\n"), contrast);
-  Serial.printf(F("             ReHoldClickTime=%dmsec\n"), hold);
-  Serial.printf(F("             ReDClickTime=%dmsec\n"), dclick);
+  console.printf(F("=================================================\n"));
+  console.printf(F("dump_eeprom: VfoFrequency=%ld\n"), freq);
+  console.printf(F("             AddressSelDigit=%d\n"), offset);
+  console.printf(F("             VfoClockOffset=%d\n"), clkoffset);
+  console.printf(F("             LcdBrightness=%d\n"), brightness);
+  console.printf(F("             LcdContrast=%d\n"), contrast);
+  console.printf(F("             ReHoldClickTime=%dmsec\n"), hold);
+  console.printf(F("             ReDClickTime=%dmsec\n"), dclick);
 
   for (int i = 0; i < NumSaveSlots; ++i)
   {
     get_slot(i, freq, offset);
-    Serial.printf(F("Slot %d: freq=%ld, seldig=%d\n"), i, freq, offset);
+    console.printf(F("Slot %d: freq=%ld, seldig=%d\n"), i, freq, offset);
   }
 
-  Serial.printf(F("=================================================\n"));
+  console.printf(F("=================================================\n"));
 }
 
 #endif
 
+// values showing the snapshot record and the whole layout are valid
+#define SNAPSHOT_MAGIC  0x534E4131    // "SNA1"
+#define LAYOUT_MARKER   0x50564631    // "PVF1"
+
+//----------------------------------------
+// Get the checksum of a snapshot record.
+//     snap  address of the record
+//----------------------------------------
+
+static uint16_t snapshot_checksum(const VFOSnapshot *snap)
+{
+  const uint8_t *p = (const uint8_t *) snap;
+  uint16_t sum = 0;
+
+  for (unsigned int i = 0; i < offsetof(VFOSnapshot, checksum); ++i)
+    sum = ((sum << 1) | (sum >> 15)) + p[i];
+
+  return sum;
+}
+
+//----------------------------------------
+// Get the saved VFO state.
+//     snap  address of record to fill in
+// Returns 'false' if there is no valid saved state.
+//----------------------------------------
+
+bool snapshot_get(VFOSnapshot *snap)
+{
+  EEPROM.get(SnapshotBase, *snap);
+  if ((snap->magic != SNAPSHOT_MAGIC) || (snap->checksum != snapshot_checksum(snap)))
+  {
+    DEBUG("snapshot_get: no valid saved state\n");
+    return false;
+  }
+
+  return true;
+}
+
+//----------------------------------------
+// Save the VFO state.
+//     snap  address of record, 'magic' and 'checksum' are ignored
+//----------------------------------------
+
+void snapshot_put(const VFOSnapshot *snap)
+{
+  VFOSnapshot record = *snap;
+
+  record.magic = SNAPSHOT_MAGIC;
+  record.checksum = snapshot_checksum(&record);
+  EEPROM.put(SnapshotBase, record);
+}
+
+//----------------------------------------
+// Prepare the EEPROM.  The slots are only cleared the first time, after
+// that they keep their contents over a reboot.
+//----------------------------------------
+
 void eeprom_init(void)
 {
-  for (int i = 0; i < 10; ++i)
+  uint32_t marker;
+
+  EEPROM.get(LayoutMarkerAddress, marker);
+  if (marker == LAYOUT_MARKER)
+    return;
+
+  DEBUG("eeprom_init: new EEPROM, clearing slots\n");
+  for (int i = 0; i < NumSaveSlots; ++i)
   {
     int freq_address = SaveFreqBase + i * sizeof(Frequency);
     int offset_address = SaveOffsetBase + i * sizeof(SelOffset);
   
-    EEPROM.put(freq_address, 0);
-    EEPROM.put(offset_address, 0);
+    EEPROM.put(freq_address, (Frequency) 0);
+    EEPROM.put(offset_address, (SelOffset) 0);
   }
+  EEPROM.put(LayoutMarkerAddress, (uint32_t) LAYOUT_MARKER);
 }
 
@@ -7,10 +7,11 @@
 
 #include <EEPROM.h>
 #include "PixelVFO.h"
+#include "dds.h"
 
 // Define the address in EEPROM of various things.
-// The "NEXT_FREE" value is the address of the next free slot address.
-// Ignore "redefine errors" - not very helpful in this case!
+// The "NEXT_FREE" value is the address of the next free slot address, it is
+// undefined before each new definition so the compiler doesn't warn.
 // The idea is that we are free to rearrange objects below with minimum fuss.
 
 // start storing at address 0
@@ -19,22 +20,27 @@
 #if 0
 // address for Frequency 'frequency'
 const int AddressFreq = NEXT_FREE;
+#undef NEXT_FREE
 #define NEXT_FREE   (AddressFreq + sizeof(Frequency))
 
 // address for int 'selected digit'
 const int AddressSelDigit = NEXT_FREE;
+#undef NEXT_FREE
 #define NEXT_FREE   (AddressSelDigit + sizeof(SelOffset))
 
 // address for 'VfoClockOffset' calibration
 const int AddressVfoClockOffset = NEXT_FREE;
+#undef NEXT_FREE
 #define NEXT_FREE   (AddressVfoClockOffset + sizeof(VfoClockOffset))
 
 // address for byte 'contrast'
 const int AddressContrast = NEXT_FREE;
+#undef NEXT_FREE
 #define NEXT_FREE   (AddressContrast + sizeof(LcdContrast))
 
 // address for byte 'brightness'
 const int AddressBrightness = NEXT_FREE;
+#undef NEXT_FREE
 #define NEXT_FREE   (AddressBrightness + sizeof(LcdBrightness))
 #endif
 
@@ -42,18 +48,67 @@ const int AddressBrightness = NEXT_FREE;
 const int NumSaveSlots = 10;
 
 const int SaveFreqBase = NEXT_FREE;
+#undef NEXT_FREE
 #define NEXT_FREE   (SaveFreqBase + NumSaveSlots * sizeof(Frequency))
 
 //also save the offset for each frequency
 const int SaveOffsetBase = NEXT_FREE;
-#define NEXT_FREE   (SaveOffsetBase + NumSaveSlots * sizeof(SelOffset);
+#undef NEXT_FREE
+#define NEXT_FREE   (SaveOffsetBase + NumSaveSlots * sizeof(SelOffset))
+
+// the calibration table, a marker followed by one error value per point
+const int CalMarkerAddress = NEXT_FREE;
+#undef NEXT_FREE
+#define NEXT_FREE   (CalMarkerAddress + sizeof(uint32_t))
+
+const int CalTableBase = NEXT_FREE;
+#undef NEXT_FREE
+#define NEXT_FREE   (CalTableBase + DDS_MAX_POINTS * sizeof(int32_t))
+
+// the VFO state saved for the next boot
+struct VFOSnapshot
+{
+  uint32_t magic;                 // SNAPSHOT_MAGIC if record written
+  Frequency freq[2];              // VFO A and B frequencies
+  SelOffset digit[2];             // VFO A and B selected digits
+  uint8_t active;                 // active register
+  uint8_t split;                  // 1 if split mode
+  uint8_t online;                 // 1 if DDS online
+  uint8_t spare;
+  unsigned long scan_dwell;       // scan and sweep settings
+  Frequency sweep_start;
+  Frequency sweep_stop;
+  Frequency sweep_step;
+  unsigned long sweep_dwell;
+  uint16_t checksum;              // over all fields above
+};
+
+const int SnapshotBase = NEXT_FREE;
+#undef NEXT_FREE
+#define NEXT_FREE   (SnapshotBase + sizeof(VFOSnapshot))
+
+// marker showing the EEPROM has been initialised
+const int LayoutMarkerAddress = NEXT_FREE;
+#undef NEXT_FREE
+#define NEXT_FREE   (LayoutMarkerAddress + sizeof(uint32_t))
 
 // additional EEPROM saved items go here
 
+// size of everything above, the image moved by a backup (see backup.h)
+const int EepromImageSize = NEXT_FREE;
+
 
 // Given slot number, return freq/offset.
 void slot_get(int slot_num, Frequency &freq, SelOffset &offset);
 void slot_put(int slot_num, Frequency freq, SelOffset offset);
 void eeprom_init(void);
 
+// save/restore the calibration table
+bool calibration_get(int32_t *ppb, int num);
+void calibration_put(const int32_t *ppb, int num);
+
+// save/restore the VFO state
+bool snapshot_get(VFOSnapshot *snap);
+void snapshot_put(const VFOSnapshot *snap);
+
 #endif
@@ -0,0 +1,110 @@
+////////////////////////////////////////////////////////////////////////////////
+// Optional rotary encoder for PixelVFO.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "PixelVFO.h"
+#include "encoder.h"
+
+volatile int32_t encoder_total = 0;
+volatile uint32_t encoder_errors = 0;
+
+// quarter-steps for each (old << 2 | new) state, ERR for a skipped state
+#define ERR   0
+static const int8_t encoder_table[16] =
+{
+   0, -1,  1, ERR,
+   1,  0, ERR, -1,
+  -1, ERR,  0,  1,
+  ERR,  1, -1,  0,
+};
+
+static uint8_t encoder_state = 0;       // last pin state, B << 1 | A
+static int8_t encoder_quarters = 0;     // quarter-steps since last detent
+static uint32_t encoder_last = 0;       // time of last detent (us)
+static int32_t encoder_taken = 0;       // 'encoder_total' at last take
+
+//----------------------------------------
+// Decode one edge.  Called from the pin interrupts.
+//     pins  new pin state, B << 1 | A
+//     now   time of the edge (microseconds)
+//----------------------------------------
+
+void encoder_edge(uint8_t pins, uint32_t now)
+{
+  uint8_t index = (encoder_state << 2) | pins;
+
+  encoder_state = pins;
+  if ((index == 0x3) || (index == 0x6) || (index == 0x9) || (index == 0xC))
+  {
+    ++encoder_errors;     // both pins changed, direction unknown
+    return;
+  }
+
+  encoder_quarters += encoder_table[index];
+  if ((encoder_quarters > -ENCODER_QUARTERS) && (encoder_quarters < ENCODER_QUARTERS))
+    return;
+
+  // a whole detent, faster turning gives bigger steps
+  uint32_t interval = now - encoder_last;
+  int32_t steps = 1;
+
+  if (interval < ENCODER_ACCEL_US3)
+    steps = ENCODER_ACCEL3;
+  else if (interval < ENCODER_ACCEL_US2)
+    steps = ENCODER_ACCEL2;
+  else if (interval < ENCODER_ACCEL_US1)
+    steps = ENCODER_ACCEL1;
+  encoder_last = now;
+
+  if (encoder_quarters < 0)
+  {
+    encoder_total = encoder_total - steps;
+    encoder_quarters += ENCODER_QUARTERS;
+  }
+  else
+  {
+    encoder_total = encoder_total + steps;
+    encoder_quarters -= ENCODER_QUARTERS;
+  }
+}
+
+#ifdef ENCODER_ENABLE
+//----------------------------------------
+// Pin interrupt handler, the same for both pins.
+//----------------------------------------
+
+static void encoder_isr(void)
+{
+  encoder_edge((digitalReadFast(ENCODER_PIN_B) << 1) | digitalReadFast(ENCODER_PIN_A),
+               micros());
+}
+#endif
+
+//----------------------------------------
+// Set up the encoder pins and interrupts.
+//----------------------------------------
+
+void encoder_init(void)
+{
+#ifdef ENCODER_ENABLE
+  pinMode(ENCODER_PIN_A, INPUT_PULLUP);
+  pinMode(ENCODER_PIN_B, INPUT_PULLUP);
+  encoder_state = (digitalReadFast(ENCODER_PIN_B) << 1) | digitalReadFast(ENCODER_PIN_A);
+  attachInterrupt(ENCODER_PIN_A, encoder_isr, CHANGE);
+  attachInterrupt(ENCODER_PIN_B, encoder_isr, CHANGE);
+#endif
+}
+
+//----------------------------------------
+// Get the steps turned since the last call.
+// Returns the signed step count.
+//----------------------------------------
+
+int32_t encoder_take(void)
+{
+  int32_t total = encoder_total;    // one aligned load, atomic
+  int32_t steps = total - encoder_taken;
+
+  encoder_taken = total;
+  return steps;
+}
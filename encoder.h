@@ -0,0 +1,49 @@
+#ifndef ENCODER_H
+#define ENCODER_H
+
+////////////////////////////////////////////////////////////////////////////////
+// Optional rotary encoder for PixelVFO.
+//
+// Both encoder pins interrupt on every edge.  The handler reads the two
+// pins and looks up the old and new state in a table, which gives +1, -1
+// or 0 quarter-steps.  Transitions that skip a state are counted as errors,
+// and the quarter-step count is kept so no detent is lost.  Each detent
+// adds 1 to 'encoder_total' or subtracts 1, multiplied when the knob is
+// turning fast.
+//
+// Only the interrupt writes 'encoder_total'.  The main loop keeps the total
+// it last took and turns the difference into steps of the selected digit,
+// so no locking is needed.
+//
+// encoder_edge() is the decoder itself.  It is given the pin states and
+// the time, so synthetic edge streams can be fed to it.
+//
+// The encoder is not compiled in unless ENCODER_ENABLE is defined.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+
+//#define ENCODER_ENABLE
+
+#define ENCODER_PIN_A       5
+#define ENCODER_PIN_B       6
+#define ENCODER_QUARTERS    4       // quarter-steps per detent
+#define ENCODER_DIGIT       (NUM_F_CHAR - 4)    // digit stepped if none selected, 1kHz
+
+// acceleration, a detent within ENCODER_ACCEL_USn of the last one
+// counts as ENCODER_ACCELn steps
+#define ENCODER_ACCEL_US1   25000
+#define ENCODER_ACCEL1      2
+#define ENCODER_ACCEL_US2   10000
+#define ENCODER_ACCEL2      4
+#define ENCODER_ACCEL_US3   4000
+#define ENCODER_ACCEL3      8
+
+extern volatile int32_t encoder_total;      // accelerated detent count
+extern volatile uint32_t encoder_errors;    // impossible transitions seen
+
+void encoder_init(void);
+void encoder_edge(uint8_t pins, uint32_t now);
+int32_t encoder_take(void);
+
+#endif
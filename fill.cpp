@@ -0,0 +1,148 @@
+////////////////////////////////////////////////////////////////////////////////
+// DMA fill engine for PixelVFO.
+//
+// The SPI library sets CTAR1 to 16 bit frames at the same clock as CTAR0,
+// so a PUSHR word selecting CTAR1 sends one RGB565 pixel.  The TFT chip
+// select and D/C lines are ordinary pins, already set by the driver.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "PixelVFO.h"
+#include "fill.h"
+#include "console.h"
+
+#ifdef FILL_DMA
+#include <DMAChannel.h>
+
+static DMAChannel fill_dma;
+static volatile uint32_t fill_word;         // PUSHR value, the DMA source
+static volatile uint32_t fill_remaining;    // pixels still to give the DMA
+static volatile bool fill_running = false;  // 'true' while DMA is running
+static bool fill_pending = false;           // 'true' until fill_wait() done
+
+//----------------------------------------
+// Start the DMA on the next chunk of the fill.
+//----------------------------------------
+
+static void fill_chunk(void)
+{
+  uint32_t count = (fill_remaining > FILL_DMA_MAX) ? FILL_DMA_MAX : fill_remaining;
+
+  fill_remaining -= count;
+  fill_dma.transferCount(count);
+  fill_dma.enable();
+}
+
+//----------------------------------------
+// DMA completion interrupt, start the next chunk or finish.
+//----------------------------------------
+
+static void fill_isr(void)
+{
+  fill_dma.clearInterrupt();
+  if (fill_remaining)
+    fill_chunk();
+  else
+    fill_running = false;
+}
+#endif
+
+FillStats fill_stats;
+
+//----------------------------------------
+// Prepare the DMA channel, call after SPI.begin().
+//----------------------------------------
+
+void fill_init(void)
+{
+#ifdef FILL_DMA
+  fill_dma.begin();
+  fill_dma.source(fill_word);
+  fill_dma.destination(SPI0_PUSHR);
+  fill_dma.triggerAtHardwareEvent(DMAMUX_SOURCE_SPI0_TX);
+  fill_dma.disableOnCompletion();
+  fill_dma.interruptAtCompletion();
+  fill_dma.attachInterrupt(fill_isr);
+#endif
+  fill_reset();
+}
+
+//----------------------------------------
+// Start sending pixels of one colour.  The display address window must
+// be set and the driver in a write transaction.
+//     color  the RGB565 colour
+//     count  number of pixels, at least 2
+//----------------------------------------
+
+void fill_start(uint16_t color, uint32_t count)
+{
+#ifdef FILL_DMA
+  fill_word = SPI_PUSHR_CTAS(1) | color;
+  fill_remaining = count - 1;       // the last one goes in fill_wait()
+  fill_running = true;
+  fill_pending = true;
+  SPI0_RSER = SPI_RSER_TFFF_RE | SPI_RSER_TFFF_DIRS;
+  fill_chunk();
+#else
+  (void) color;
+  (void) count;
+#endif
+}
+
+//----------------------------------------
+// Returns 'true' if a fill has been started and not waited for.
+//----------------------------------------
+
+bool fill_busy(void)
+{
+#ifdef FILL_DMA
+  return fill_pending;
+#else
+  return false;
+#endif
+}
+
+//----------------------------------------
+// Wait until a fill has been completely sent.
+//----------------------------------------
+
+void fill_wait(void)
+{
+#ifdef FILL_DMA
+  if (!fill_pending)
+    return;
+
+  while (fill_running)
+    ;
+  SPI0_RSER = 0;
+
+  // the last pixel marks the end of the queue
+  SPI0_PUSHR = fill_word | SPI_PUSHR_EOQ;
+  while (!(SPI0_SR & SPI_SR_EOQF))
+    ;
+  SPI0_SR = SPI_SR_EOQF;
+  SPI0_MCR |= SPI_MCR_CLR_RXF;      // drop the data clocked in
+
+  fill_pending = false;
+#endif
+}
+
+//----------------------------------------
+// Send the statistics over the serial port, reply to "ZF;":
+//     ZFfills,pixels,dma_fills,dma_pixels,round_rects,spans;
+//----------------------------------------
+
+void fill_report(void)
+{
+  console.printf("ZF%lu,%lu,%lu,%lu,%lu,%lu;",
+                (unsigned long) fill_stats.fills,
+                (unsigned long) fill_stats.pixels,
+                (unsigned long) fill_stats.dma_fills,
+                (unsigned long) fill_stats.dma_pixels,
+                (unsigned long) fill_stats.round_rects,
+                (unsigned long) fill_stats.spans);
+}
+
+void fill_reset(void)
+{
+  memset(&fill_stats, 0, sizeof(fill_stats));
+}
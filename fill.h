@@ -0,0 +1,51 @@
+#ifndef FILL_H
+#define FILL_H
+
+////////////////////////////////////////////////////////////////////////////////
+// DMA fill engine for PixelVFO.
+//
+// On the Teensy, a solid fill of FILL_DMA_MIN or more pixels is sent by DMA
+// if the panel takes 16 bit pixels (see panel.h).
+// The DMA copies one constant SPI0 PUSHR word, the colour plus the 16 bit
+// frame select, into the SPI FIFO each time the FIFO has room.  There is no
+// pixel buffer, and the CPU is free until the next display access.  The
+// display driver calls fill_wait() before it touches the SPI bus again.
+//
+// Fills bigger than one DMA major loop are sent in chunks, restarted from
+// the DMA completion interrupt.  The last pixel is pushed by the CPU with
+// the end-of-queue flag, so fill_wait() knows when the SPI has finished.
+//
+// On other targets fills are drawn by the normal driver code.  The fills
+// that would have used DMA are still counted, so the saving can be seen.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+
+#if defined(KINETISK)
+#define FILL_DMA                    // fills are done by DMA
+#endif
+
+#define FILL_DMA_MIN    256         // smallest fill worth a DMA transfer (pixels)
+#define FILL_DMA_MAX    32767       // most pixels in one DMA major loop
+
+// fill statistics
+struct FillStats
+{
+  uint32_t fills;         // solid rectangle fills
+  uint32_t pixels;        // pixels in those fills
+  uint32_t dma_fills;     // fills done by (or eligible for) DMA
+  uint32_t dma_pixels;    // pixels in those fills
+  uint32_t round_rects;   // rounded rectangles filled
+  uint32_t spans;         // rectangles they were split into
+};
+
+extern FillStats fill_stats;
+
+void fill_init(void);
+void fill_start(uint16_t color, uint32_t count);
+bool fill_busy(void);
+void fill_wait(void);
+void fill_report(void);
+void fill_reset(void);
+
+#endif
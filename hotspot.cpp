@@ -8,6 +8,8 @@
 
 #include "PixelVFO.h"
 #include "hotspot.h"
+#include "overlay.h"
+#include "console.h"
 
 //----------------------------------------
 // Format one HotSpot struct into a display string.
@@ -35,15 +37,15 @@ const char *hs_display(HotSpot *hs)
 
 void hs_dump(char const *msg, HotSpot *hs_array, int len)
 {
-  Serial.printf("~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n");
-  Serial.printf("HotSpot array: %s\n", msg);
+  console.printf("~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n");
+  console.printf("HotSpot array: %s\n", msg);
   for (int i = 0; i < len; ++i)
   {
     HotSpot *hs = &hs_array[i];
 
-    Serial.printf("  %d: %s\n", i, hs_display(hs));
+    console.printf("  %d: %s\n", i, hs_display(hs));
   }
-  Serial.printf("~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n");
+  console.printf("~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n");
 }
 
 //----------------------------------------
@@ -59,7 +61,7 @@ bool hs_handletouch(int touch_x, int touch_y, HotSpot *hs, int hs_len)
 {
   for (int i = 0; i < hs_len; ++hs, ++i)
   {
-    DEBUG("***** hs: x=%d, y=%d, arg=%s\n", hs->x, hs->y, hs->arg);
+    DEBUG("***** hs: x=%d, y=%d, arg=%d\n", hs->x, hs->y, hs->arg);
     
     if ((touch_x >= hs->x) && (touch_x < hs->x + hs->w) &&
         (touch_y >= hs->y) && (touch_y < hs->y + hs->h))
@@ -104,3 +106,54 @@ HotSpot * hs_touched(int touch_x, int touch_y, HotSpot *hs, int hs_len)
   return result;
 }
 
+
+//----------------------------------------
+// Get the part of a hotspot that is on the screen.
+//     hs          address of the HotSpot
+//     x, y, w, h  references to cells to receive the rectangle
+//----------------------------------------
+
+static void hs_visible(const HotSpot *hs, int &x, int &y, int &w, int &h)
+{
+  x = hs->x;
+  y = hs->y;
+  w = min(hs->w, tft.width() - hs->x);
+  h = min(hs->h, tft.height() - hs->y);
+}
+
+//----------------------------------------
+// Show that a hotspot has been pressed, call before its handler.
+//     hs  address of the HotSpot touched
+//----------------------------------------
+
+void hs_press(const HotSpot *hs)
+{
+  int x, y, w, h;
+
+  hs_visible(hs, x, y, w, h);
+  tft.fillRect(x, y, w, HS_PRESS_W, HS_PRESS_FG);
+  tft.fillRect(x, y + h - HS_PRESS_W, w, HS_PRESS_W, HS_PRESS_FG);
+  tft.fillRect(x, y + HS_PRESS_W, HS_PRESS_W, h - 2*HS_PRESS_W, HS_PRESS_FG);
+  tft.fillRect(x + w - HS_PRESS_W, y + HS_PRESS_W, HS_PRESS_W, h - 2*HS_PRESS_W, HS_PRESS_FG);
+  tft.flush();
+}
+
+//----------------------------------------
+// Remove the press frame, if the handler didn't redraw the screen.
+//     hs  address of the HotSpot touched
+// Returns 'false' if the screen has no widget table and the frame is
+// still there.  Don't call while an overlay is open.
+//----------------------------------------
+
+bool hs_release(const HotSpot *hs)
+{
+  int x, y, w, h;
+
+  hs_visible(hs, x, y, w, h);
+  overlay_open();
+  overlay_cover(x, y, w, HS_PRESS_W);
+  overlay_cover(x, y + h - HS_PRESS_W, w, HS_PRESS_W);
+  overlay_cover(x, y + HS_PRESS_W, HS_PRESS_W, h - 2*HS_PRESS_W);
+  overlay_cover(x + w - HS_PRESS_W, y + HS_PRESS_W, HS_PRESS_W, h - 2*HS_PRESS_W);
+  return overlay_close();
+}
@@ -7,10 +7,19 @@
 // The idea is to define rectangular extents on the screen with associated
 // handler functions and arguments.  Given a touchscreen touch event with
 // associated (x, y) coordinates, call the appropriate handler (if any).
+//
+// Event loops call hs_press() on the touched hotspot before its handler, so
+// the user sees the press at once even if the handler is slow.  It draws a
+// frame just inside the hotspot and flushes it to the display.  If the
+// handler doesn't redraw the screen, hs_release() puts back what the frame
+// covered, from the widget table of the screen (see overlay.h).
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <Arduino.h>
 
+#define HS_PRESS_FG     ILI9341_WHITE   // colour of the press frame
+#define HS_PRESS_W      3               // width of the press frame
+
 // forward definition of HotSpot struct
 struct HotSpot;
 
@@ -33,6 +42,8 @@ struct HotSpot
 bool hs_handletouch(int touch_x, int touch_y, HotSpot *hs, int hs_len);
 HotSpot * hs_touched(int touch_x, int touch_y, HotSpot *hs, int hs_len);
 const char *hs_display(HotSpot *hs);
+void hs_press(const HotSpot *hs);
+bool hs_release(const HotSpot *hs);
 void hs_dump(char const *msg, HotSpot *hs, int len);
 
 #endif
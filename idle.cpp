@@ -0,0 +1,124 @@
+////////////////////////////////////////////////////////////////////////////////
+// Adaptive idle mode for PixelVFO.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "PixelVFO.h"
+#include "idle.h"
+#include "console.h"
+
+IdleStats idle_stats;
+
+static int idle_irq_pin;                  // XPT2046 pen IRQ pin
+static volatile bool idle_pen_irq;        // set by pen IRQ interrupt
+static unsigned long idle_last_activity;  // millis() of last touch
+static unsigned long idle_last_sample;    // millis() of last read
+static unsigned long idle_interval;       // current fallback interval (ms)
+static unsigned long idle_sleep_rem;      // sleep time not yet in 'sleep_ms' (us)
+
+//----------------------------------------
+// Pen IRQ interrupt, just note the edge.  Also wakes the CPU from WFI.
+//----------------------------------------
+
+static void idle_pen_isr(void)
+{
+  idle_pen_irq = true;
+}
+
+//----------------------------------------
+// Prepare the idle mode.
+//     irq_pin  the XPT2046 pen IRQ pin
+//----------------------------------------
+
+void idle_init(int irq_pin)
+{
+  idle_irq_pin = irq_pin;
+  pinMode(irq_pin, INPUT_PULLUP);
+  attachInterrupt(irq_pin, idle_pen_isr, FALLING);
+  idle_reset();
+  idle_activity();
+}
+
+//----------------------------------------
+// Note user activity, which ends any idle period.
+//----------------------------------------
+
+void idle_activity(void)
+{
+  idle_last_activity = millis();
+  idle_interval = IDLE_MIN_INTERVAL;
+}
+
+//----------------------------------------
+// Decide if the touch controller should be read.
+//     pen_down  'true' if the pen was down at the last read
+// Returns 'true' if a read is due.
+//----------------------------------------
+
+bool idle_sample_due(bool pen_down)
+{
+  unsigned long now = millis();
+  bool irq = idle_pen_irq;
+
+  idle_pen_irq = false;
+  if (pen_down || irq || (digitalRead(idle_irq_pin) == LOW)
+      || (now - idle_last_activity < IDLE_ACTIVE_TIME))
+  {
+    idle_last_sample = now;
+    ++idle_stats.samples;
+    return true;
+  }
+
+  if (now - idle_last_sample >= idle_interval)
+  {
+    idle_last_sample = now;
+    if (idle_interval < IDLE_MAX_INTERVAL)
+      idle_interval *= 2;
+    ++idle_stats.samples;
+    ++idle_stats.fallback;
+    return true;
+  }
+
+  ++idle_stats.skipped;
+  return false;
+}
+
+//----------------------------------------
+// Sleep until the next interrupt.  Only called when idle.
+//----------------------------------------
+
+void idle_sleep(void)
+{
+  if (console_pending())
+    return;         // output is waiting for USB buffers
+
+  unsigned long start = micros();
+
+#if defined(__arm__)
+  asm volatile("wfi");
+#endif
+
+  idle_sleep_rem += micros() - start;
+  idle_stats.sleep_ms += idle_sleep_rem / 1000;
+  idle_sleep_rem %= 1000;
+  ++idle_stats.sleeps;
+}
+
+//----------------------------------------
+// Send the statistics over the serial port, format in idle.h.
+//----------------------------------------
+
+void idle_report(void)
+{
+  console.printf("ZI%lu,%lu,%lu,%lu,%lu,%lu;",
+                (unsigned long) idle_stats.samples,
+                (unsigned long) idle_stats.fallback,
+                (unsigned long) idle_stats.skipped,
+                (unsigned long) idle_stats.sleeps,
+                (unsigned long) idle_stats.sleep_ms, millis());
+}
+
+void idle_reset(void)
+{
+  memset(&idle_stats, 0, sizeof(idle_stats));
+  idle_sleep_rem = 0;
+}
@@ -0,0 +1,51 @@
+#ifndef IDLE_H
+#define IDLE_H
+
+////////////////////////////////////////////////////////////////////////////////
+// Adaptive idle mode for PixelVFO.
+//
+// For IDLE_ACTIVE_TIME after the last touch, the touch controller is read
+// on every poll as before.  After that the VFO is idle.  A sample is then
+// taken only if the XPT2046 pen IRQ line is low, or if the fallback
+// interval has passed.  The interval doubles from IDLE_MIN_INTERVAL up to
+// IDLE_MAX_INTERVAL.  The IRQ line is read as a level, so a lost interrupt
+// can't lose a touch, and the fallback poll still finds touches if the
+// IRQ line doesn't work at all.
+//
+// When idle and no sample is due, the CPU sleeps with WFI until the next
+// interrupt.  That is the 1ms system tick at the latest, or sooner for the
+// pen IRQ, USB or the sweep/scan timers, so tap latency doesn't change.
+//
+// The statistics are sent with the "ZI;" CAT command:
+//
+//     ZIsamples,fallback,skipped,sleeps,sleep_ms,uptime_ms;
+//
+// and "ZI0;" clears them.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+
+#define IDLE_ACTIVE_TIME    5000    // ms after a touch before going idle
+#define IDLE_MIN_INTERVAL   20      // first fallback poll interval (ms)
+#define IDLE_MAX_INTERVAL   320     // longest fallback poll interval (ms)
+
+// polling and power statistics
+struct IdleStats
+{
+  uint32_t samples;       // touch controller reads
+  uint32_t fallback;      // reads made only because the interval passed
+  uint32_t skipped;       // polls without a read
+  uint32_t sleeps;        // WFI sleeps
+  uint32_t sleep_ms;      // time asleep (milliseconds)
+};
+
+void idle_init(int irq_pin);
+bool idle_sample_due(bool pen_down);
+void idle_sleep(void);
+void idle_activity(void);
+void idle_report(void);
+void idle_reset(void);
+
+extern IdleStats idle_stats;
+
+#endif
@@ -0,0 +1,111 @@
+////////////////////////////////////////////////////////////////////////////////
+// Touch-to-photon latency measurement for PixelVFO.
+//
+// The bucket counts saturate rather than wrap, so a long soak test never
+// turns a bad histogram into a good one.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "PixelVFO.h"
+#include "latency.h"
+#include "console.h"
+
+bool latency_armed = false;             // 'true' while a touch is being timed
+unsigned long latency_flush_time;       // end of last SPI transaction (us)
+
+static LatencyScreen latency_screen;    // screen the timed touch was on
+static unsigned long latency_start;     // time of the timed touch (us)
+
+static const unsigned long latency_limits[LAT_NUM_BUCKETS-1] = LAT_BUCKET_LIMITS;
+static uint32_t latency_hist[LAT_NumScreens][LAT_NUM_BUCKETS];
+static unsigned long latency_max[LAT_NumScreens];
+
+//----------------------------------------
+// Start timing a new touch.
+//     screen  the screen the touch was seen on
+//     start   micros() when the touch was sampled
+//----------------------------------------
+
+void latency_touch(LatencyScreen screen, unsigned long start)
+{
+  latency_screen = screen;
+  latency_start = start;
+  latency_flush_time = latency_start;
+  latency_armed = true;
+}
+
+//----------------------------------------
+// Finish timing the last touch, if any, called when an event loop polls.
+//----------------------------------------
+
+void latency_poll(void)
+{
+  if (!latency_armed)
+    return;
+  latency_armed = false;
+
+  unsigned long latency = latency_flush_time - latency_start;
+
+  if (latency == 0)
+    return;           // touch didn't draw anything
+
+  int bucket = 0;
+  while ((bucket < LAT_NUM_BUCKETS-1) && (latency > latency_limits[bucket]))
+    ++bucket;
+
+  if (latency_hist[latency_screen][bucket] != 0xFFFFFFFF)
+    ++latency_hist[latency_screen][bucket];
+  if (latency > latency_max[latency_screen])
+    latency_max[latency_screen] = latency;
+
+  DEBUG("latency_poll: screen %d, %ldus\n", latency_screen, latency);
+}
+
+//----------------------------------------
+// Clear all histograms.
+//----------------------------------------
+
+void latency_reset(void)
+{
+  memset(latency_hist, 0, sizeof(latency_hist));
+  memset(latency_max, 0, sizeof(latency_max));
+  latency_armed = false;
+}
+
+//----------------------------------------
+// Send the histograms over the serial port, format in latency.h.
+//----------------------------------------
+
+void latency_report(void)
+{
+  for (int screen = 0; screen < LAT_NumScreens; ++screen)
+  {
+    console.printf("ZL%d", screen);
+    for (int bucket = 0; bucket < LAT_NUM_BUCKETS; ++bucket)
+      console.printf(",%lu", (unsigned long) latency_hist[screen][bucket]);
+    console.printf(",%lu;", latency_max[screen]);
+  }
+}
+
+//----------------------------------------
+// Check a screen's latency against a limit.
+//     screen   the screen to check
+//     limit    the latency limit (microseconds)
+//     percent  percentage of touches that must be inside the limit
+// Returns 'true' if enough touches were inside the limit.  A touch only
+// counts as inside if its whole bucket is, so the check is pessimistic.
+//----------------------------------------
+
+bool latency_gate(LatencyScreen screen, unsigned long limit, int percent)
+{
+  uint32_t total = 0;
+  uint32_t inside = 0;
+
+  for (int bucket = 0; bucket < LAT_NUM_BUCKETS; ++bucket)
+  {
+    total += latency_hist[screen][bucket];
+    if ((bucket < LAT_NUM_BUCKETS-1) && (latency_limits[bucket] <= limit))
+      inside += latency_hist[screen][bucket];
+  }
+
+  return inside * 100ULL >= total * (uint64_t) percent;
+}
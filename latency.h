@@ -0,0 +1,58 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+////////////////////////////////////////////////////////////////////////////////
+// Touch-to-photon latency measurement for PixelVFO.
+//
+// pen_touch() stamps each new touch with the time it was sampled and the
+// screen it was reported on.  Every SPI transaction that ends after that moves the "last
+// flush" time on.  When an event loop next polls pen_touch(), the drawing
+// caused by the touch is finished, and the time from touch to last flush
+// goes into that screen's histogram.  Touches that draw nothing are not
+// counted.
+//
+// The histograms are sent with the "ZL;" CAT command, one line per screen:
+//
+//     ZLs,c0,c1,...,c9,max;
+//
+// where 's' is the screen number, 'cN' the count in bucket N and 'max' the
+// worst latency seen in microseconds.  "ZL0;" clears the histograms.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+
+// the screen types we keep histograms for
+enum LatencyScreen
+{
+  LAT_Main,           // main VFO screen
+  LAT_Keypad,         // frequency keypad
+  LAT_Menu,           // any menu
+  LAT_Dialog,         // alerts, confirms and full-screen actions
+  LAT_NumScreens      // must be last
+};
+
+// upper limits of the histogram buckets (microseconds), last is open-ended
+#define LAT_BUCKET_LIMITS   {1000, 2000, 5000, 10000, 20000, 50000, \
+                             100000, 200000, 500000}
+#define LAT_NUM_BUCKETS     10
+
+void latency_touch(LatencyScreen screen, unsigned long start);
+void latency_poll(void);
+void latency_reset(void);
+void latency_report(void);
+bool latency_gate(LatencyScreen screen, unsigned long limit, int percent);
+
+//----------------------------------------
+// Note the end of an SPI transaction, called from the display driver.
+//----------------------------------------
+
+extern bool latency_armed;
+extern unsigned long latency_flush_time;
+
+inline void latency_flush(void)
+{
+  if (latency_armed)
+    latency_flush_time = micros();
+}
+
+#endif
@@ -0,0 +1,272 @@
+////////////////////////////////////////////////////////////////////////////////
+// Levelled logging for PixelVFO.
+//
+// A binary log record in the ring buffer is:
+//     format address, number of args | string args mask << 8, args...
+// all as 32 bit words.  A string arg is its length in bytes followed by the
+// bytes, four to a word, the first in the low byte.  Records that don't fit
+// are dropped and counted.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "log.h"
+
+static unsigned long log_drops = 0;     // number of dropped records
+
+#ifdef LOG_BINARY
+static uint32_t log_ring[LOG_RING_WORDS];
+static volatile int log_head = 0;       // next word written here
+static volatile int log_tail = 0;       // next word read from here
+
+//----------------------------------------
+// Store a binary log record.
+//     format   address of the printf-style format string
+//     args     address of the raw argument words
+//     num      number of argument words
+//     strings  mask of the args that are strings, bit 0 is the first
+// Strings are copied, up to LOG_STR_MAX-1 bytes.
+// Safe to call from interrupt code.
+//----------------------------------------
+
+void log_record(const char *format, const uint32_t *args, int num, uint32_t strings)
+{
+  const char *str[LOG_MAX_ARGS];
+  int len[LOG_MAX_ARGS];
+  int need = 2;
+
+  for (int i = 0; i < num; ++i)
+  {
+    if (strings & (1UL << i))
+    {
+      str[i] = (args[i]) ? (const char *) args[i] : "(null)";
+      len[i] = strnlen(str[i], LOG_STR_MAX - 1);
+      need += 1 + (len[i] + 3) / 4;
+    }
+    else
+    {
+      need += 1;
+    }
+  }
+
+  __disable_irq();
+
+  int used = (log_head - log_tail + LOG_RING_WORDS) % LOG_RING_WORDS;
+
+  if (used + need >= LOG_RING_WORDS)
+  {
+    ++log_drops;
+  }
+  else
+  {
+    int head = log_head;
+
+    log_ring[head] = (uint32_t) format;
+    head = (head + 1) % LOG_RING_WORDS;
+    log_ring[head] = num | (strings << 8);
+    head = (head + 1) % LOG_RING_WORDS;
+    for (int i = 0; i < num; ++i)
+    {
+      if (strings & (1UL << i))
+      {
+        log_ring[head] = len[i];
+        head = (head + 1) % LOG_RING_WORDS;
+        for (int j = 0; j < len[i]; j += 4)
+        {
+          uint32_t word = 0;
+
+          for (int k = 0; (k < 4) && (j + k < len[i]); ++k)
+            word |= (uint32_t) (uint8_t) str[i][j + k] << (8 * k);
+          log_ring[head] = word;
+          head = (head + 1) % LOG_RING_WORDS;
+        }
+      }
+      else
+      {
+        log_ring[head] = args[i];
+        head = (head + 1) % LOG_RING_WORDS;
+      }
+    }
+    log_head = head;
+  }
+
+  __enable_irq();
+}
+
+//----------------------------------------
+// Format a binary log record into a buffer.
+//     buff    address of buffer to fill
+//     size    size of 'buff'
+//     format  the printf-style format string
+//     args    address of the raw argument words
+//     strs    address of the copied strings, NULL for args that aren't
+//     num     number of argument words
+//
+// Each conversion is formatted on its own by snprintf(), cast back to
+// the type its conversion character expects.
+//----------------------------------------
+
+static void log_format(char *buff, int size, const char *format, const uint32_t *args,
+                       char * const *strs, int num)
+{
+  int len = 0;
+  int arg = 0;
+
+  while (*format && (len < size - 1))
+  {
+    if (*format != '%')
+    {
+      buff[len++] = *format++;
+      continue;
+    }
+
+    // copy the conversion spec, eg, "%08lx"
+    char spec[16];
+    int slen = 0;
+
+    spec[slen++] = *format++;
+    while (*format && !strchr("diouxXcspn%", *format) && (slen < (int) sizeof(spec) - 2))
+      spec[slen++] = *format++;
+    if (!*format)
+      break;
+    char conv = *format++;
+    spec[slen++] = conv;
+    spec[slen] = '\0';
+
+    uint32_t value = (arg < num) ? args[arg] : 0;
+    int room = size - len;
+    int n;
+
+    switch (conv)
+    {
+      case '%':
+        n = snprintf(buff + len, room, "%%");
+        break;
+      case 'd':
+      case 'i':
+        n = (strchr(spec, 'l')) ? snprintf(buff + len, room, spec, (long) value)
+                                : snprintf(buff + len, room, spec, (int) value);
+        ++arg;
+        break;
+      case 's':
+        n = snprintf(buff + len, room, spec, (arg < num && strs[arg]) ? strs[arg] : "(?)");
+        ++arg;
+        break;
+      case 'p':
+        n = snprintf(buff + len, room, spec, (void *) value);
+        ++arg;
+        break;
+      case 'n':
+        n = 0;
+        ++arg;
+        break;
+      default:
+        n = (strchr(spec, 'l')) ? snprintf(buff + len, room, spec, (unsigned long) value)
+                                : snprintf(buff + len, room, spec, (unsigned int) value);
+        ++arg;
+        break;
+    }
+
+    if (n > 0)
+      len += (n < room) ? n : room - 1;
+  }
+
+  buff[len] = '\0';
+}
+#else
+//----------------------------------------
+// Format and write a log message.
+//     format  the printf-style format string
+//     ...     the args to 'format'
+//
+// Messages longer than LOG_BUFF_SIZE are truncated.
+//----------------------------------------
+
+void log_write(const char *format, ...)
+{
+  char buff[LOG_BUFF_SIZE];
+  va_list aptr;
+
+  va_start(aptr, format);
+  vsnprintf(buff, sizeof(buff), format, aptr);
+  va_end(aptr);
+
+  LOG_SERIAL.print(buff);
+}
+#endif
+
+//----------------------------------------
+// Format and write any stored binary log records, and report any text the
+// console dropped.  Call when the VFO is idle.
+//----------------------------------------
+
+void log_flush(void)
+{
+#ifdef LOG_BINARY
+  static char strings[LOG_MAX_ARGS][LOG_STR_MAX];
+
+  while (log_tail != log_head)
+  {
+    char buff[LOG_BUFF_SIZE];
+    uint32_t args[LOG_MAX_ARGS];
+    char *strs[LOG_MAX_ARGS];
+    int tail = log_tail;
+    const char *format = (const char *) log_ring[tail];
+
+    tail = (tail + 1) % LOG_RING_WORDS;
+    int num = log_ring[tail] & 0xFF;
+    uint32_t is_string = log_ring[tail] >> 8;
+    tail = (tail + 1) % LOG_RING_WORDS;
+    for (int i = 0; i < num; ++i)
+    {
+      args[i] = log_ring[tail];
+      strs[i] = NULL;
+      tail = (tail + 1) % LOG_RING_WORDS;
+
+      if (is_string & (1UL << i))
+      {
+        int len = args[i];
+
+        for (int j = 0; j < len; j += 4)
+        {
+          uint32_t word = log_ring[tail];
+
+          for (int k = 0; (k < 4) && (j + k < len); ++k)
+            strings[i][j + k] = word >> (8 * k);
+          tail = (tail + 1) % LOG_RING_WORDS;
+        }
+        strings[i][len] = '\0';
+        strs[i] = strings[i];
+      }
+    }
+    log_tail = tail;
+
+    log_format(buff, sizeof(buff), format, args, strs, num);
+    LOG_SERIAL.print(buff);
+  }
+
+  static unsigned long reported = 0;
+  if (log_drops != reported)
+  {
+    LOG_SERIAL.printf("log: %lu records dropped\n", log_drops - reported);
+    reported = log_drops;
+  }
+#endif
+
+  // text the console dropped, once the host is reading again
+  static unsigned long console_reported = 0;
+  unsigned long drops = console_dropped();
+
+  if ((drops != console_reported) && (console_pending() == 0))
+  {
+    LOG_SERIAL.printf("console: %lu writes dropped\n", drops - console_reported);
+    console_reported = drops;
+  }
+}
+
+//----------------------------------------
+// Returns the number of log records dropped because the ring was full.
+//----------------------------------------
+
+unsigned long log_dropped(void)
+{
+  return log_drops;
+}
@@ -0,0 +1,124 @@
+#ifndef LOG_H
+#define LOG_H
+
+////////////////////////////////////////////////////////////////////////////////
+// Levelled logging for PixelVFO.
+//
+// Log calls below LOG_LEVEL compile to nothing, including their arguments.
+//
+// If LOG_BINARY is defined, a log call doesn't format anything.  It stores
+// the format string address and the raw argument values in a ring buffer,
+// and log_flush() formats them later when the VFO is idle.  The format
+// string must not change, so it must be a literal.  A "%s" argument is
+// copied into the ring, up to LOG_STR_MAX-1 characters, so it may point
+// at a buffer that is reused.  Other arguments must be no bigger than 32
+// bits.  Formats are checked against their arguments as printf() would be.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+#include "console.h"
+
+#define LOG_LEVEL_NONE      0
+#define LOG_LEVEL_ERROR     1
+#define LOG_LEVEL_WARN      2
+#define LOG_LEVEL_INFO      3
+#define LOG_LEVEL_DEBUG     4
+#define LOG_LEVEL_TRACE     5     // also dumps whole structures
+
+// configure logging here
+#ifndef LOG_LEVEL
+#define LOG_LEVEL           LOG_LEVEL_WARN
+#endif
+//#define LOG_BINARY
+
+#define LOG_SERIAL          console
+#define LOG_BUFF_SIZE       256     // longest formatted log line
+#define LOG_RING_WORDS      512     // size of binary log ring buffer
+#define LOG_MAX_ARGS        8       // most args in a binary log call
+#define LOG_STR_MAX         128     // longest "%s" string stored, with '\0'
+
+#ifdef LOG_BINARY
+void log_record(const char *format, const uint32_t *args, int num, uint32_t strings);
+
+// convert one argument to a 32 bit word
+template <typename T> inline uint32_t log_word(T value)
+{
+  static_assert(sizeof(T) <= sizeof(uint32_t), "log argument bigger than 32 bits");
+  return (uint32_t) value;
+}
+
+template <typename T> inline uint32_t log_word(T *value)
+{
+  return (uint32_t) value;
+}
+
+// 'true' if an argument is a string, copied into the ring
+template <typename T> inline bool log_is_string(T)
+{
+  return false;
+}
+
+inline bool log_is_string(const char *)
+{
+  return true;
+}
+
+inline bool log_is_string(char *)
+{
+  return true;
+}
+
+template <typename... Args> inline void log_write(const char *format, Args... args)
+{
+  static_assert(sizeof...(args) <= LOG_MAX_ARGS, "too many log arguments");
+  const uint32_t words[] = {0, log_word(args)...};   // leading 0 for no args
+  const bool is_string[] = {false, log_is_string(args)...};
+  uint32_t strings = 0;
+
+  for (unsigned i = 0; i < sizeof...(args); ++i)
+    if (is_string[i + 1])
+      strings |= 1UL << i;
+
+  log_record(format, words + 1, sizeof...(args), strings);
+}
+
+// never called, lets the compiler check a format against its arguments
+inline void log_check(const char *format, ...) __attribute__((format(printf, 1, 2)));
+inline void log_check(const char *, ...) {}
+
+#define LOG_CALL(...)       do { if (false) log_check(__VA_ARGS__); \
+                                 log_write(__VA_ARGS__); } while (0)
+#else
+void log_write(const char *format, ...) __attribute__((format(printf, 1, 2)));
+
+#define LOG_CALL(...)       log_write(__VA_ARGS__)
+#endif
+
+void log_flush(void);
+unsigned long log_dropped(void);
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(...)      LOG_CALL(__VA_ARGS__)
+#else
+#define LOG_ERROR(...)      do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(...)       LOG_CALL(__VA_ARGS__)
+#else
+#define LOG_WARN(...)       do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(...)       LOG_CALL(__VA_ARGS__)
+#else
+#define LOG_INFO(...)       do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...)      LOG_CALL(__VA_ARGS__)
+#else
+#define LOG_DEBUG(...)      do {} while (0)
+#endif
+
+#endif
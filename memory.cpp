@@ -0,0 +1,107 @@
+////////////////////////////////////////////////////////////////////////////////
+// RAM usage monitor for PixelVFO.
+//
+// The Teensy RAM layout, low to high:
+//
+//     _sdata .. _ebss      static data
+//     _ebss .. sbrk(0)     heap
+//     sbrk(0) .. SP        free
+//     SP .. _estack        stack
+////////////////////////////////////////////////////////////////////////////////
+
+#include <malloc.h>
+
+#include "PixelVFO.h"
+#include "memory.h"
+#include "console.h"
+
+extern "C" char *sbrk(int i);
+extern char _sdata;         // linker symbols
+extern char _ebss;
+extern char _estack;
+
+static volatile uint32_t *mem_painted = NULL;   // bottom of painted RAM
+static uint32_t mem_heap_peak = 0;              // biggest heap seen
+
+//----------------------------------------
+// Paint free RAM, call first thing in setup().
+//----------------------------------------
+
+void mem_init(void)
+{
+  uintptr_t bottom = (uintptr_t) sbrk(0) + MEM_HEAP_RESERVE;
+  uintptr_t top = (uintptr_t) __builtin_frame_address(0) - MEM_PAINT_MARGIN;
+
+  mem_painted = (volatile uint32_t *) ((bottom + 3) & ~3);
+  for (volatile uint32_t *p = mem_painted; p < (volatile uint32_t *) top; ++p)
+    *p = MEM_PAINT;
+
+  mem_heap_peak = sbrk(0) - &_ebss;
+}
+
+//----------------------------------------
+// Check the guard words and note the heap size.
+// Returns MEM_Ok, or which side has reached the guard words.
+//
+// The heap has if its top is above the bottom of the painted RAM,
+// otherwise a guard word can only have been overwritten by the stack.
+//----------------------------------------
+
+MemFault mem_check(void)
+{
+  uint32_t heap = sbrk(0) - &_ebss;
+
+  if (heap > mem_heap_peak)
+    mem_heap_peak = heap;
+
+  if ((uintptr_t) sbrk(0) > (uintptr_t) mem_painted)
+  {
+    LOG_ERROR("mem_check: heap top %p is above the guard words\n", sbrk(0));
+    return MEM_Heap;
+  }
+
+  for (int i = 0; i < MEM_GUARD_WORDS; ++i)
+  {
+    if (mem_painted[i] != MEM_PAINT)
+    {
+      LOG_ERROR("mem_check: guard word %d overwritten\n", i);
+      return MEM_Stack;
+    }
+  }
+
+  return MEM_Ok;
+}
+
+//----------------------------------------
+// Get the current RAM usage.
+//     info  address of struct to fill in
+//----------------------------------------
+
+void mem_info(MemInfo *info)
+{
+  volatile uint32_t *p = mem_painted;
+
+  while ((p < (volatile uint32_t *) &_estack) && (*p == MEM_PAINT))
+    ++p;
+
+  info->static_size = &_ebss - &_sdata;
+  info->heap_size = sbrk(0) - &_ebss;
+  info->heap_peak = mem_heap_peak;
+  info->heap_used = mallinfo().uordblks;
+  info->stack_peak = &_estack - (char *) p;
+  info->stack_free = (char *) p - (char *) mem_painted;
+}
+
+//-----------------------------------------------
+// Debug routine - Dump some memory usage information.
+//-----------------------------------------------
+
+void dump_mem(const char *msg)
+{
+  MemInfo info;
+
+  mem_info(&info);
+  console.printf("@@@@@ %s: static=%lu, heap=%lu/%lu (peak %lu), stack peak=%lu, free=%lu\n",
+                msg, info.static_size, info.heap_used, info.heap_size,
+                info.heap_peak, info.stack_peak, info.stack_free);
+}
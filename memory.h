@@ -0,0 +1,48 @@
+#ifndef MEMORY_H
+#define MEMORY_H
+
+////////////////////////////////////////////////////////////////////////////////
+// RAM usage monitor for PixelVFO.
+//
+// At boot the free RAM between the heap and the stack is painted with a
+// pattern.  The lowest unpainted word is the stack high-water mark.  A
+// few guard words at the bottom of the painted area are checked from the
+// main loop, so a stack/heap collision stops the VFO rather than
+// corrupting it.
+//
+// Nothing in PixelVFO calls malloc() at runtime, so after boot the heap
+// only holds what the libraries allocate.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+
+#define MEM_PAINT           0xC5C5C5C5  // pattern painted on unused RAM
+#define MEM_HEAP_RESERVE    1024        // bytes left unpainted above heap
+#define MEM_PAINT_MARGIN    64          // bytes left unpainted below SP
+#define MEM_GUARD_WORDS     8           // words checked by mem_check()
+
+// RAM usage figures, all in bytes
+struct MemInfo
+{
+  uint32_t static_size;   // initialised and zeroed data
+  uint32_t heap_size;     // heap arena (now)
+  uint32_t heap_peak;     // heap arena (highest seen by mem_check())
+  uint32_t heap_used;     // heap allocated (now)
+  uint32_t stack_peak;    // deepest stack seen
+  uint32_t stack_free;    // painted RAM the stack has never reached
+};
+
+// results of mem_check()
+enum MemFault
+{
+  MEM_Ok,         // guard words intact
+  MEM_Stack,      // the stack reached the guard words
+  MEM_Heap,       // the heap reached the guard words
+};
+
+void mem_init(void);
+MemFault mem_check(void);
+void mem_info(MemInfo *info);
+void dump_mem(const char *msg);
+
+#endif
@@ -11,6 +11,10 @@
 #include "menu.h"
 #include "hotspot.h"
 #include "utils.h"
+#include "profile.h"
+#include "text.h"
+#include "overlay.h"
+#include "console.h"
 
 // constants for the menu system
 #define MENU_SCROLL_WIDTH   20
@@ -28,10 +32,13 @@
 #define MENUBACK_Y          ((DEPTH_FREQ_DISPLAY - MENUBACK_HEIGHT)/2)
 #define MENU_ITEM_BG        0x0700
 
+// the menu being shown, saved and restored around submenus
+static MenuCursor menu_cursor = {NULL, 0};
+
 
 // function forward definitions
 //const char *mi_display(struct MenuItem *mi);
-//void menu_dump(char const *msg, Menu *menu);
+//void menu_dump(char const *msg, const Menu *menu);
 
 //----------------------------------------
 // Handler if user clicks on "Back" button.
@@ -52,7 +59,7 @@ bool hs_menuback_handler(HotSpot *hs)
 
 bool hs_menuitem_handler(HotSpot *hs)
 {
-  MenuItem *mi_ptr = (MenuItem *) hs->arg;    // address of MenuItem to action
+  const MenuItem *mi_ptr = &menu_cursor.menu->items[menu_cursor.top + hs->arg];
   
   DEBUG(">>>>> hs_menuitem_handler: entered, hs=\n%s\nmi=\n%s\n",
         hs_display(hs), mi_display(mi_ptr));
@@ -76,15 +83,13 @@ bool hs_menuitem_handler(HotSpot *hs)
 
 bool menu_scroll_up(HotSpot *hs)
 {
-  Menu *menu = (Menu *) hs->arg;    // address of Menu to action
-
-  // add 1 to menu 'top' value and normalize
-  if (menu->top != 0) 
+  // subtract 1 from menu 'top' value and normalize
+  if (menu_cursor.top != 0) 
   {
     // we can scroll
-    menu->top -= 1;
-    if (menu->top < 0)
-        menu->top = 0;
+    menu_cursor.top -= 1;
+    if (menu_cursor.top < 0)
+        menu_cursor.top = 0;
     return true;    // redraw screen
   }
   else
@@ -101,17 +106,19 @@ bool menu_scroll_up(HotSpot *hs)
 
 bool menu_scroll_down(HotSpot *hs)
 {
-  Menu *menu = (Menu *) hs->arg;    // address of Menu to action
+  const Menu *menu = menu_cursor.menu;
 
+#if LOG_LEVEL >= LOG_LEVEL_TRACE
   menu_dump("menu_scroll_down: menu", menu); 
+#endif
 
   // add 1 to menu 'top' value and normalize
-  if (menu->top < (menu->num_items - MAXMENUITEMROWS))
+  if (menu_cursor.top < (menu->num_items - MAXMENUITEMROWS))
   {
     // we can scroll
-    menu->top += 1;
-    if (menu->top > menu->num_items - MAXMENUITEMROWS)
-        menu->top = menu->num_items - MAXMENUITEMROWS;
+    menu_cursor.top += 1;
+    if (menu_cursor.top > menu->num_items - MAXMENUITEMROWS)
+        menu_cursor.top = menu->num_items - MAXMENUITEMROWS;
     return true;    // redraw screen
   }
   else
@@ -154,12 +161,12 @@ static HotSpot hs_back[] =
 // Debug function.
 //----------------------------------------
 
-const char *mi_display(struct MenuItem *mi)
+const char *mi_display(const struct MenuItem *mi)
 {
   static char buffer[128];
 
-  sprintf(buffer, "mi: %p, title='%s', menu=%p, action=%p, arg=%08X\n",
-          mi, mi->title, mi->menu, mi->action, (unsigned int) mi->arg);
+  sprintf(buffer, "mi: %p, title='%s', menu=%p, action=%p, arg=%d\n",
+          mi, mi->title, mi->menu, mi->action, mi->arg);
   
   return buffer;
 }
@@ -172,19 +179,18 @@ const char *mi_display(struct MenuItem *mi)
 // Debug function.
 //----------------------------------------
 
-void menu_dump(char const *msg, Menu *menu)
+void menu_dump(const char *msg, const Menu *menu)
 {
-  Serial.printf("~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n");
-  Serial.printf("Menu: %s\n", msg);
-  Serial.printf("  title=%s, top=%d, num items=%d, indexed=%s\n",
-                menu->title, menu->top, menu->num_items, (menu->indexed) ? "true" : "false");
+  console.printf("~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n");
+  console.printf("Menu: %s\n", msg);
+  console.printf("  title=%s, num items=%d, indexed=%s\n",
+                menu->title, menu->num_items, (menu->indexed) ? "true" : "false");
 
   for (int i = 0; i < menu->num_items; ++i)
   {
-    struct MenuItem *mi_ptr = menu->items[i];
-    Serial.printf("    mi %d: %s", i, mi_display(mi_ptr));
+    console.printf("    mi %d: %s", i, mi_display(&menu->items[i]));
   }
-  Serial.printf("~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n");
+  console.printf("~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n");
 }
 
 
@@ -199,101 +205,165 @@ void menuBackButton(void)
 }
 
 //----------------------------------------
-// Draw a menu on the screen.
-//     menu  pointer to a Menu structure
+// Draw the menu title bar.
+//     menu  address of the menu
 //----------------------------------------
-  
-void menu_draw(struct Menu *menu)
-{
-  DEBUG(">>>>>>>>>> menu_draw: entered, menu title=%s\n", menu->title);
 
-  // clear screen and write menu title on upper row
-  tft.fillScreen(SCREEN_BG);
-  tft.setTextWrap(false);
-    
-  // start drawing things that don't change
+static void menu_draw_title(const Menu *menu)
+{
   tft.fillRect(0, 0, ts_width, DEPTH_FREQ_DISPLAY, FREQ_BG);
   tft.setCursor(TITLE_OFFSET_X, TITLE_OFFSET_Y);
   tft.setTextColor(MENU_FG);
   tft.setFont(FONT_MENU);
   tft.print(menu->title);
   menuBackButton();
+}
+
+//----------------------------------------
+// Draw one row of menu items.
+//     cursor  address of the menu and top row
+//     row     the screen row, 0 at top
+// Rows below the last item are left empty.
+//----------------------------------------
+
+static void menu_draw_row(const MenuCursor *cursor, int row)
+{
+  const Menu *menu = cursor->menu;
+  int i = cursor->top + row;
+  int mi_y = DEPTH_FREQ_DISPLAY + MENUITEM_HEIGHT*(row + 1);
+
+  if (i >= menu->num_items)
+    return;
 
-  // draw menuitems (at least, those that fit on screen
   tft.setFont(FONT_MENUITEM);
-  int mi_y = DEPTH_FREQ_DISPLAY + MENUITEM_HEIGHT;
-  for (int i = menu->top; i < menu->top + MAXMENUITEMROWS; ++i)
-  {
-    if (i >= menu->num_items)
-    {
-      break;
-    }
+  tft.setTextColor(MENU_FG);
 
-    int16_t x1;
-    int16_t y1;
-    uint16_t w;
-    uint16_t h;
-     
-    tft.getTextBounds((char *) menu->items[i]->title, 1, 1, &x1, &y1, &w, &h);
+  int w = text_label_width(FONT_MENUITEM, menu->items[i].title);
 
-    // write indexed item on lower row, right-justified
-    tft.fillRect(0, mi_y - MENUITEM_HEIGHT, ts_width-1, MENUITEM_HEIGHT - 1, MENU_BG);
-    tft.setCursor(ts_width - w - 5, mi_y - 10);
-    tft.print(menu->items[i]->title);
+  // write indexed item on lower row, right-justified
+  tft.fillRect(0, mi_y - MENUITEM_HEIGHT, ts_width-1, MENUITEM_HEIGHT - 1, MENU_BG);
+  tft.setCursor(ts_width - w - 5, mi_y - 10);
+  tft.print(menu->items[i].title);
 
-    // if we are indexing, write index text in correct column
-    if (menu->indexed)
-    {
-      char buff[16];
+  // if we are indexing, write index text in correct column
+  if (menu->indexed)
+  {
+    char buff[16];
 
-      sprintf(buff, "%d:", i);
-      //tft.getTextBounds(buff, 1, 1, &x1, &y1, &w, &h);
-      tft.setCursor(INDEX_COLUMN, mi_y - 10);
-      tft.print(buff);
-    }
-    
-    mi_y += MENUITEM_HEIGHT;
+    sprintf(buff, "%d:", i);
+    tft.setCursor(INDEX_COLUMN, mi_y - 10);
+    tft.print(buff);
   }
+}
+
+//----------------------------------------
+// Draw the scroll widget, if the menu needs one.
+//     menu  address of the menu
+//----------------------------------------
+
+static void menu_draw_scroll(const Menu *menu)
+{
+  if (menu->num_items <= MAXMENUITEMROWS)
+    return;
+
+  tft.fillRect(MENU_SCROLL_OFFSET, DEPTH_FREQ_DISPLAY,
+               MENU_SCROLL_WIDTH, ts_height - DEPTH_FREQ_DISPLAY, SCROLL_BG);
+  tft.fillTriangle(MENU_SCROLL_OFFSET, DEPTH_FREQ_DISPLAY+SCROLL_HEIGHT,
+                   MENU_SCROLL_OFFSET + MENU_SCROLL_WIDTH-1, DEPTH_FREQ_DISPLAY+SCROLL_HEIGHT,
+                   MENU_SCROLL_OFFSET + MENU_SCROLL_WIDTH/2, DEPTH_FREQ_DISPLAY,
+                   SCROLL_FG);
+  tft.fillTriangle(MENU_SCROLL_OFFSET, ts_height-1-SCROLL_HEIGHT,
+                   MENU_SCROLL_OFFSET + MENU_SCROLL_WIDTH-1, ts_height-1-SCROLL_HEIGHT,
+                   MENU_SCROLL_OFFSET + MENU_SCROLL_WIDTH/2, ts_height-1,
+                   SCROLL_FG);
+}
+
+// widget args for the menu screen, rows are 0 to MAXMENUITEMROWS-1
+#define MW_TITLE    -1
+#define MW_SCROLL   -2
+
+//----------------------------------------
+// Redraw one widget of the menu being shown, for overlay_close().
+//     arg  a row number, MW_TITLE or MW_SCROLL
+//----------------------------------------
+
+static void menu_widget_draw(int arg)
+{
+  if (arg == MW_TITLE)
+    menu_draw_title(menu_cursor.menu);
+  else if (arg == MW_SCROLL)
+    menu_draw_scroll(menu_cursor.menu);
+  else
+    menu_draw_row(&menu_cursor, arg);
+}
+
+// menu screen widgets in z-order, see overlay.h
+static const Widget menu_widgets[] =
+{
+  {0, 0, ts_width, ts_height, SCREEN_BG, NULL, 0},
+  {0, 0, ts_width, DEPTH_FREQ_DISPLAY, 0, menu_widget_draw, MW_TITLE},
+  {0, DEPTH_FREQ_DISPLAY+MENUITEM_HEIGHT*0, ts_width, MENUITEM_HEIGHT, 0, menu_widget_draw, 0},
+  {0, DEPTH_FREQ_DISPLAY+MENUITEM_HEIGHT*1, ts_width, MENUITEM_HEIGHT, 0, menu_widget_draw, 1},
+  {0, DEPTH_FREQ_DISPLAY+MENUITEM_HEIGHT*2, ts_width, MENUITEM_HEIGHT, 0, menu_widget_draw, 2},
+  {0, DEPTH_FREQ_DISPLAY+MENUITEM_HEIGHT*3, ts_width, MENUITEM_HEIGHT, 0, menu_widget_draw, 3},
+  {0, DEPTH_FREQ_DISPLAY+MENUITEM_HEIGHT*4, ts_width, MENUITEM_HEIGHT, 0, menu_widget_draw, 4},
+  {MENU_SCROLL_OFFSET, DEPTH_FREQ_DISPLAY, MENU_SCROLL_WIDTH, ts_height-DEPTH_FREQ_DISPLAY,
+   0, menu_widget_draw, MW_SCROLL},
+};
+
+static_assert(ALEN(menu_widgets) == MAXMENUITEMROWS + 3, "menu_widgets rows must match MAXMENUITEMROWS");
+
+//----------------------------------------
+// Draw a menu on the screen.
+//     cursor  address of the menu and top row to draw
+//----------------------------------------
   
-  // draw the scroll widget if required
-  if (menu->num_items > MAXMENUITEMROWS)
-  {
-    tft.fillRect(MENU_SCROLL_OFFSET, DEPTH_FREQ_DISPLAY,
-                 MENU_SCROLL_WIDTH, ts_height - DEPTH_FREQ_DISPLAY, SCROLL_BG);
-    tft.fillTriangle(MENU_SCROLL_OFFSET, DEPTH_FREQ_DISPLAY+SCROLL_HEIGHT,
-                     MENU_SCROLL_OFFSET + MENU_SCROLL_WIDTH-1, DEPTH_FREQ_DISPLAY+SCROLL_HEIGHT,
-                     MENU_SCROLL_OFFSET + MENU_SCROLL_WIDTH/2, DEPTH_FREQ_DISPLAY,
-                     SCROLL_FG);
-    tft.fillTriangle(MENU_SCROLL_OFFSET, ts_height-1-SCROLL_HEIGHT,
-                     MENU_SCROLL_OFFSET + MENU_SCROLL_WIDTH-1, ts_height-1-SCROLL_HEIGHT,
-                     MENU_SCROLL_OFFSET + MENU_SCROLL_WIDTH/2, ts_height-1,
-                     SCROLL_FG);
-  }
+void menu_draw(const MenuCursor *cursor)
+{
+  const Menu *menu = cursor->menu;
+
+  PROFILE_ZONE(PZ_MenuDraw);
+  DEBUG(">>>>>>>>>> menu_draw: entered, menu title=%s\n", menu->title);
+
+  // clear screen and write menu title on upper row
+  tft.fillScreen(SCREEN_BG);
+  tft.setTextWrap(false);
+  menu_draw_title(menu);
+
+  // draw menuitems (at least, those that fit on screen)
+  for (int row = 0; row < MAXMENUITEMROWS; ++row)
+    menu_draw_row(cursor, row);
+  
+  menu_draw_scroll(menu);
+  overlay_screen(menu_widgets, ALEN(menu_widgets));
 
   DEBUG("<<<<<<<<<< menu_draw: exit, menu title=%s\n", menu->title);
 }
 
 //----------------------------------------
-// Handle a touch on a menu hotspot.
+// Handle a touch on a menu hotspot of the menu being shown.
 //     x        X coord of screen touch
 //     y        Y coord of screen touch
 //     hs       base address of array of HotSpots
 //     hslen    length of 'hs_array'
 //     is_menu  'true' if this a MenuItem touch
-//     menu     address of menu structure (NULL if no menu)
 //
-// If spot selected then call menu action routine if 'menu' not NULL,
+// If spot selected then call menu action routine if 'is_menu' is 'true',
 // else call HotSpot action routine.  Return value of either routine.
 //
 // Returns 'true' if menu is finished.
 //----------------------------------------
 
-bool menu_handletouch(int x, int y, HotSpot *hs, int hslen, bool is_menu, struct Menu *menu)
+bool menu_handletouch(int x, int y, HotSpot *hs, int hslen, bool is_menu)
 {
-  DEBUG(">>>>>>>>>>>>>>> menu_handletouch: entered, x=%d, y=%d, is_menu=%s, hslen=%d, menu->top=%d\n",
-        x, y, is_menu ? "true" : "false", hslen, menu->top);
+  const Menu *menu = menu_cursor.menu;
+
+  DEBUG(">>>>>>>>>>>>>>> menu_handletouch: entered, x=%d, y=%d, is_menu=%s, hslen=%d, top=%d\n",
+        x, y, is_menu ? "true" : "false", hslen, menu_cursor.top);
+#if LOG_LEVEL >= LOG_LEVEL_TRACE
   menu_dump("Menu:", menu);
   hs_dump("Hotspots:", hs, hslen);
+#endif
 
   int max_scan = (is_menu) ? MAXMENUITEMROWS : hslen;
 
@@ -302,11 +372,16 @@ bool menu_handletouch(int x, int y, HotSpot *hs, int hslen, bool is_menu, struct
     if ((x >= hs->x) && (x < hs->x + hs->w) &&
         (y >= hs->y) && (y < hs->y + hs->h))
     {
-      int ndx = i + menu->top;   // index of actual menuitem/action
+      int ndx = i + menu_cursor.top;   // index of actual menuitem/action
             
       if (is_menu)
       { // we have a menu
-        struct MenuItem *mi = menu->items[ndx];
+        if (ndx >= menu->num_items)
+          return false;     // touch on an empty row
+
+        const struct MenuItem *mi = &menu->items[ndx];
+
+        hs_press(hs);
 
         if (mi->menu)
         {
@@ -317,19 +392,22 @@ bool menu_handletouch(int x, int y, HotSpot *hs, int hslen, bool is_menu, struct
         }
         else
         {
-          DEBUG("menu_handletouch: calling mi->action('%08x')\n", (unsigned long) mi->arg);
+          DEBUG("menu_handletouch: calling mi->action(%d)\n", mi->arg);
           bool result = mi->action(mi->arg);
-          //menu_draw(menu);
           DEBUG("<<<<<<<<<<<<<<< menu_handletouch: action, returning '%s'\n",
                 (result) ? "true" : "false");
+          if (!result)
+            hs_release(hs);
           return result;
         }
       }
       else
       { // just call action HotSpot routine
         DEBUG("menu_handletouch: calling HotSpot handler: %p\n", hs->handler);
-        hs->arg = (int) menu;    // dynamically plug menu to handle into HotSpot
+        hs_press(hs);
         bool result = hs->handler(hs);
+        if (!result)
+          hs_release(hs);
         DEBUG("menu_handletouch: returning '%s'\n", (result) ? "true" : "false");
         return result;
       }
@@ -343,17 +421,22 @@ bool menu_handletouch(int x, int y, HotSpot *hs, int hslen, bool is_menu, struct
 //**************************************
 // Draw a menu on the screen.
 //     menu  address of the Menu structure to draw
+//
+// The cursor of any menu we were called from is put back on return.
 //**************************************
 
-void menu_show(struct Menu *menu)
+void menu_show(const struct Menu *menu)
 { 
   DEBUG(">>>>> menu_show: entered, menu->title=%s\n", menu->title);
 
+  MenuCursor parent = menu_cursor;
+
   // first draw of menu, set scroll to top of menuitems
-  menu->top = 0;
+  menu_cursor.menu = menu;
+  menu_cursor.top = 0;
 
   // draw the menu screen
-  menu_draw(menu);
+  menu_draw(&menu_cursor);
           
   // event loop for handling menu
   while (true)
@@ -361,31 +444,31 @@ void menu_show(struct Menu *menu)
     int x;    // pen touch coordinates
     int y;
   
-    if (pen_touch(&x, &y))
+    if (pen_touch(&x, &y, LAT_Menu))
     {
       DEBUG("menu_show: Checking menuitem touch\n");
-      if (menu_handletouch(x, y, hs_menu, ALEN(hs_menu), true, menu))
+      if (menu_handletouch(x, y, hs_menu, ALEN(hs_menu), true))
       {
         DEBUG("<<<<< menu_show: menuitem touch handled, menu->title=%s\n", menu->title);
-        menu_draw(menu);
+        menu_draw(&menu_cursor);
         continue;
       }
 
       DEBUG("menu_show: Checking scroll touch\n");
-      if (menu_handletouch(x, y, hs_scroll, ALEN(hs_scroll), false, menu))
+      if (menu_handletouch(x, y, hs_scroll, ALEN(hs_scroll), false))
       {
         DEBUG("<<<<< menu_show: 'scroll' touch handled, menu->title=%s\n", menu->title);
-        menu_draw(menu);
+        menu_draw(&menu_cursor);
         continue;
       }
       
       DEBUG("menu_show: Checking BACK touch\n");
-      if (menu_handletouch(x, y, hs_back, ALEN(hs_back), false, menu))
+      if (menu_handletouch(x, y, hs_back, ALEN(hs_back), false))
       {
         DEBUG("<<<<< menu_show: 'BACK' touch handled, menu->title=%s\n", menu->title);
+        menu_cursor = parent;
         return;
       }
     }
   }
 }
-
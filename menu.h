@@ -7,6 +7,9 @@
 // The idea is to define a menu definition with an associated hotspot
 // definition.  The code draws the menu and items on the screen and uses the
 // hotspot definition to handle screen touches and operation of the menu.
+//
+// Menu and MenuItem data is 'constexpr' so it lives in flash.  The only
+// changeable state is the MenuCursor of the menu being shown.
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <Arduino.h>
@@ -14,27 +17,57 @@
 
 
 // handler for selection of an item
-typedef bool (*ItemAction)(void *arg);
+typedef bool (*ItemAction)(int arg);
 
 // structure defining a menuitem
 struct MenuItem
 {
   const char *title;          // menu item display text
-  struct Menu *menu;          // if not NULL, submenu to pass to show_menu()
+  const struct Menu *menu;    // if not NULL, submenu to pass to show_menu()
   ItemAction action;          // if not NULL, address of action function
-  void *arg;                  // arg for the action function
+  int arg;                    // arg for the action function
 };
 
 // structure defining a menu
 struct Menu
 {
-  const char *title;          // title displayed on menu screen
+  const char *title;              // title displayed on menu screen
+  int num_items;                  // number of items in the array below
+  const struct MenuItem *items;   // array of MenuItem data
+  bool indexed;                   // 'true' if menu is indexed
+};
+
+// navigation state of the menu being shown
+struct MenuCursor
+{
+  const struct Menu *menu;    // the menu on the screen
   int top;                    // index of top displayed item
-  int num_items;              // number of items in the array below
-  struct MenuItem **items;    // array of pointers to MenuItem data
-  bool indexed;               // 'true' if menu is indexed
 };
 
+//----------------------------------------
+// Check a menu definition at compile time, use in a static_assert().
+//     menu  address of the Menu to check
+// Returns 'true' if the menu has a title and items, and every item has a
+// title and exactly one of a submenu or an action.  Submenus are checked
+// where they are defined.
+//----------------------------------------
+
+constexpr bool menu_valid(const struct Menu *menu)
+{
+  if ((menu->title == NULL) || (menu->num_items <= 0) || (menu->items == NULL))
+    return false;
+
+  for (int i = 0; i < menu->num_items; ++i)
+  {
+    const struct MenuItem *mi = &menu->items[i];
+
+    if ((mi->title == NULL) || ((mi->menu == NULL) == (mi->action == NULL)))
+      return false;
+  }
+
+  return true;
+}
+
 #define MENU_FG             ILI9341_BLACK
 #define MENU_BG             ILI9341_GREEN
 #define MENUITEM_HEIGHT     38
@@ -45,9 +78,10 @@ struct Menu
 
 
 // menu functions
-void menu_dump(const char *msg, struct Menu *menu);
-const char *mi_display(struct MenuItem *mi);
+void menu_dump(const char *msg, const struct Menu *menu);
+const char *mi_display(const struct MenuItem *mi);
 void menuBackButton(void);
+void menu_draw(const struct MenuCursor *cursor);
 
 //**************************************
 // Draw a menu on the screen.
@@ -56,6 +90,6 @@ void menuBackButton(void);
 // 'false' if the menu is to be redrawn.
 //**************************************
 
-void menu_show(struct Menu *menu);
+void menu_show(const struct Menu *menu);
 
 #endif
@@ -0,0 +1,549 @@
+////////////////////////////////////////////////////////////////////////////////
+// Screen mirroring over the USB serial port.
+//
+// Each hooked primitive is only encoded when called from outside the
+// driver, ie, 'depth' is 0.  The Adafruit code calls its own virtual
+// primitives, and without this a fillRect() would also be sent as the
+// lines it is made from.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "PixelVFO.h"
+#include "mirror.h"
+#include "fill.h"
+#include "spibus.h"
+#include "console.h"
+
+#define MIRROR_SYNC1      0xA5
+#define MIRROR_SYNC2      0x5A
+#define MIRROR_SKIP       0x8000
+#define MIRROR_MAX_RUN    0x7FFF
+
+static bool mirror_on = false;          // 'true' if mirroring
+static bool mirror_full = false;        // 'true' if full frame needed
+static bool mirror_wait = false;        // 'true' to wait for space, not drop
+
+// the tile gathering single pixels
+static uint16_t tile_color[MIRROR_TILE_H][MIRROR_TILE_W];
+static uint8_t tile_mask[MIRROR_TILE_H][(MIRROR_TILE_W + 7) / 8];
+static bool tile_used = false;          // 'true' if tile holds pixels
+static int16_t tile_x;                  // screen position of tile
+static int16_t tile_y;
+static int16_t tile_x1;                 // bounding box of pixels in tile
+static int16_t tile_y1;
+static int16_t tile_x2;
+static int16_t tile_y2;
+
+//----------------------------------------
+// Routines to write a message into the console buffer.
+// If a message doesn't fit, the console drops all of it.
+//----------------------------------------
+
+static void mirror_begin(void)
+{
+  console_begin((mirror_wait) ? MIRROR_WAIT_MS : 0);
+}
+
+static void mirror_byte(uint8_t b)
+{
+  console_byte(b);
+}
+
+static void mirror_u16(uint16_t value)
+{
+  mirror_byte(value & 0xFF);
+  mirror_byte(value >> 8);
+}
+
+static void mirror_end(void)
+{
+  if (!console_end())
+    mirror_full = true;     // screen on host is now wrong
+}
+
+//----------------------------------------
+// Start a rectangle message.
+//----------------------------------------
+
+static void mirror_rect_header(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  mirror_begin();
+  mirror_byte(MIRROR_SYNC1);
+  mirror_byte(MIRROR_SYNC2);
+  mirror_byte('R');
+  mirror_u16(x);
+  mirror_u16(y);
+  mirror_u16(w);
+  mirror_u16(h);
+}
+
+//----------------------------------------
+// Send a solid filled rectangle.
+//----------------------------------------
+
+static void mirror_fill(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+  // clip to screen
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > tft.width()) w = tft.width() - x;
+  if (y + h > tft.height()) h = tft.height() - y;
+  if ((w <= 0) || (h <= 0))
+    return;
+
+  uint32_t pixels = (uint32_t) w * h;
+
+  mirror_rect_header(x, y, w, h);
+  while (pixels > 0)
+  {
+    uint16_t run = (pixels > MIRROR_MAX_RUN) ? MIRROR_MAX_RUN : pixels;
+
+    mirror_u16(run);
+    mirror_u16(color);
+    pixels -= run;
+  }
+  mirror_end();
+}
+
+//----------------------------------------
+// Send the pixels gathered in the tile and empty it.
+//----------------------------------------
+
+static void tile_flush(void)
+{
+  if (!tile_used)
+    return;
+
+  int w = tile_x2 - tile_x1 + 1;
+  int h = tile_y2 - tile_y1 + 1;
+  uint16_t run = 0;
+  bool run_skip = false;
+  uint16_t run_color = 0;
+
+  mirror_rect_header(tile_x + tile_x1, tile_y + tile_y1, w, h);
+
+  for (int y = tile_y1; y <= tile_y2; ++y)
+  {
+    for (int x = tile_x1; x <= tile_x2; ++x)
+    {
+      bool skip = !(tile_mask[y][x >> 3] & (1 << (x & 7)));
+      uint16_t color = tile_color[y][x];
+
+      if ((run > 0) &&
+          ((skip != run_skip) || (!skip && (color != run_color)) || (run == MIRROR_MAX_RUN)))
+      {
+        mirror_u16((run_skip) ? (MIRROR_SKIP | run) : run);
+        if (!run_skip)
+          mirror_u16(run_color);
+        run = 0;
+      }
+      run_skip = skip;
+      run_color = color;
+      ++run;
+    }
+  }
+  mirror_u16((run_skip) ? (MIRROR_SKIP | run) : run);
+  if (!run_skip)
+    mirror_u16(run_color);
+
+  mirror_end();
+
+  memset(tile_mask, 0, sizeof(tile_mask));
+  tile_used = false;
+}
+
+//----------------------------------------
+// Add a single pixel to the tile.
+// If the pixel is outside the tile, the tile is sent and restarted.
+//----------------------------------------
+
+static void tile_pixel(int16_t x, int16_t y, uint16_t color)
+{
+  if ((x < 0) || (y < 0) || (x >= tft.width()) || (y >= tft.height()))
+    return;
+
+  int tx = x - tile_x;
+  int ty = y - tile_y;
+
+  if (tile_used && ((tx < 0) || (ty < 0) || (tx >= MIRROR_TILE_W) || (ty >= MIRROR_TILE_H)))
+  {
+    tile_flush();
+  }
+
+  if (!tile_used)
+  {
+    // glyphs are drawn top row first, but may extend left of first pixel
+    tile_x = max(0, x - MIRROR_TILE_W / 2);
+    tile_y = y;
+    tile_x1 = tile_x2 = tx = x - tile_x;
+    tile_y1 = tile_y2 = ty = 0;
+    tile_used = true;
+  }
+
+  tile_color[ty][tx] = color;
+  tile_mask[ty][tx >> 3] |= 1 << (tx & 7);
+  if (tx < tile_x1) tile_x1 = tx;
+  if (tx > tile_x2) tile_x2 = tx;
+  if (ty < tile_y1) tile_y1 = ty;
+  if (ty > tile_y2) tile_y2 = ty;
+}
+
+//----------------------------------------
+// The hooked drawing primitives.
+//----------------------------------------
+
+template <class P>
+void MirrorTFT<P>::startWrite(void)
+{
+  flush();
+  ++batch;
+  Driver::startWrite();
+  spi_begin(SPI_Display);
+}
+
+template <class P>
+void MirrorTFT<P>::endWrite(void)
+{
+  // leave the transaction open while a DMA fill runs, see flush()
+  if (fill_busy())
+  {
+    end_pending = true;
+  }
+  else
+  {
+    Driver::endWrite();
+    spi_end(SPI_Display);
+    latency_flush();
+  }
+  if ((--batch == 0) && mirror_on)
+    tile_flush();
+}
+
+//----------------------------------------
+// Every burst of pixels starts with a new address window, so this is
+// where the display gives the bus to a higher priority SPI job.
+//----------------------------------------
+
+template <class P>
+void MirrorTFT<P>::setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+  fill_wait();
+  if (spi_preempt_due(SPI_Display))
+  {
+    Driver::endWrite();
+    spi_preempt(SPI_Display);
+    Driver::startWrite();
+  }
+  Driver::setAddrWindow(x, y, w, h);
+}
+
+//----------------------------------------
+// Wait for any DMA fill and end its write transaction.
+//----------------------------------------
+
+template <class P>
+void MirrorTFT<P>::flush(void)
+{
+  fill_wait();
+  if (end_pending)
+  {
+    end_pending = false;
+    Driver::endWrite();
+    spi_end(SPI_Display);
+    latency_flush();
+  }
+}
+
+//----------------------------------------
+// Fill a rectangle, by DMA if it is big enough.  Clips like the
+// Adafruit code.  Must be called in a write transaction.  A DMA fill
+// is sent in bands of at most SPI_BURST_MAX pixels, each band waits
+// for the one before and starts at a preemption point.
+//----------------------------------------
+
+template <class P>
+void MirrorTFT<P>::fill_rect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+  if (w < 0)
+  {
+    x += w + 1;
+    w = -w;
+  }
+  if (h < 0)
+  {
+    y += h + 1;
+    h = -h;
+  }
+
+  int16_t x2 = x + w - 1;
+  int16_t y2 = y + h - 1;
+
+  if ((w == 0) || (h == 0) || (x >= this->_width) || (y >= this->_height) || (x2 < 0) || (y2 < 0))
+    return;
+  if (x < 0)
+    x = 0;
+  if (y < 0)
+    y = 0;
+  if (x2 >= this->_width)
+    x2 = this->_width - 1;
+  if (y2 >= this->_height)
+    y2 = this->_height - 1;
+  w = x2 - x + 1;
+  h = y2 - y + 1;
+
+  uint32_t count = (uint32_t) w * h;
+
+  ++fill_stats.fills;
+  fill_stats.pixels += count;
+  if ((P::pixel_bytes == 2) && (count >= FILL_DMA_MIN))
+  {
+    ++fill_stats.dma_fills;
+    fill_stats.dma_pixels += count;
+#ifdef FILL_DMA
+    int16_t band = SPI_BURST_MAX / w;     // rows per band, at least 30
+
+    for (int16_t row = 0; row < h; row += band)
+    {
+      int16_t rows = (h - row < band) ? h - row : band;
+
+      setAddrWindow(x, y + row, w, rows);
+      fill_start(color, (uint32_t) w * rows);
+    }
+    return;
+#endif
+  }
+
+  Driver::writeFillRect(x, y, w, h, color);
+}
+
+//----------------------------------------
+// Get the inset of one row of a rounded corner.
+//     r    corner radius
+//     row  row counted from the outside edge, 0 to r-1
+//----------------------------------------
+
+static int16_t round_inset(int16_t r, int16_t row)
+{
+  int32_t d = 2 * (r - row) - 1;          // 2 * distance of row centre from arc centre
+  int32_t span2 = 4 * r * r - d * d;      // (2 * half-chord) squared
+  int16_t x = 0;
+
+  while (4 * (x + 1) * (x + 1) <= span2)
+    ++x;
+
+  return r - x;
+}
+
+//----------------------------------------
+// Fill a rounded rectangle as a few horizontal spans.  Corner rows with
+// the same inset are merged into one span.
+//----------------------------------------
+
+template <class P>
+void MirrorTFT<P>::fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color)
+{
+  int16_t max_r = ((w < h) ? w : h) / 2;
+
+  if (r > max_r)
+    r = max_r;
+
+  ++fill_stats.round_rects;
+  startWrite();
+  writeFillRect(x, y + r, w, h - 2 * r, color);
+  ++fill_stats.spans;
+
+  for (int16_t row = 0; row < r; )
+  {
+    int16_t inset = round_inset(r, row);
+    int16_t rows = 1;
+
+    while ((row + rows < r) && (round_inset(r, row + rows) == inset))
+      ++rows;
+
+    writeFillRect(x + inset, y + row, w - 2 * inset, rows, color);
+    writeFillRect(x + inset, y + h - row - rows, w - 2 * inset, rows, color);
+    fill_stats.spans += 2;
+    row += rows;
+  }
+  endWrite();
+}
+
+template <class P>
+void MirrorTFT<P>::drawPixel(int16_t x, int16_t y, uint16_t color)
+{
+  if (mirror_on && (depth == 0))
+    tile_pixel(x, y, color);
+  ++depth;
+  Driver::drawPixel(x, y, color);
+  --depth;
+  if (mirror_on && (batch == 0))
+    tile_flush();
+}
+
+template <class P>
+void MirrorTFT<P>::writePixel(int16_t x, int16_t y, uint16_t color)
+{
+  if (mirror_on && (depth == 0))
+    tile_pixel(x, y, color);
+  ++depth;
+  Driver::writePixel(x, y, color);
+  --depth;
+}
+
+// all the filled shapes are handled the same way
+#define MIRROR_FILL(x, y, w, h, color, call)    \
+  if (mirror_on && (depth == 0))                \
+  {                                             \
+    tile_flush();                               \
+    mirror_fill(x, y, w, h, color);             \
+  }                                             \
+  ++depth;                                      \
+  call;                                         \
+  --depth;
+
+template <class P>
+void MirrorTFT<P>::writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+  MIRROR_FILL(x, y, w, h, color, fill_rect(x, y, w, h, color));
+}
+
+template <class P>
+void MirrorTFT<P>::writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+{
+  MIRROR_FILL(x, y, 1, h, color, Driver::writeFastVLine(x, y, h, color));
+}
+
+template <class P>
+void MirrorTFT<P>::writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+  MIRROR_FILL(x, y, w, 1, color, Driver::writeFastHLine(x, y, w, color));
+}
+
+template <class P>
+void MirrorTFT<P>::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+{
+  MIRROR_FILL(x, y, 1, h, color, Driver::drawFastVLine(x, y, h, color));
+}
+
+template <class P>
+void MirrorTFT<P>::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+  MIRROR_FILL(x, y, w, 1, color, Driver::drawFastHLine(x, y, w, color));
+}
+
+template <class P>
+void MirrorTFT<P>::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+  MIRROR_FILL(x, y, w, h, color, startWrite(); fill_rect(x, y, w, h, color); endWrite());
+}
+
+template <class P>
+void MirrorTFT<P>::fillScreen(uint16_t color)
+{
+  MIRROR_FILL(0, 0, this->width(), this->height(), color, Driver::fillScreen(color));
+}
+
+//----------------------------------------
+// Start and stop mirroring.
+// On start a full frame header is sent and the screen must be redrawn,
+// see mirror_poll().
+//----------------------------------------
+
+void mirror_start(void)
+{
+  memset(tile_mask, 0, sizeof(tile_mask));
+  tile_used = false;
+  mirror_full = true;
+  mirror_on = true;
+  DEBUG("mirror_start: called\n");
+}
+
+void mirror_stop(void)
+{
+  mirror_on = false;
+  DEBUG("mirror_stop: called\n");
+}
+
+bool mirror_active(void)
+{
+  return mirror_on;
+}
+
+//----------------------------------------
+// Choose what happens when the console buffer is full.
+//     wait  'true' to wait for the host to take data, 'false' to drop
+//
+// Waiting makes the stream lossless, for snapshots.  If the host stops
+// reading for MIRROR_WAIT_MS the damage is dropped after all.
+//----------------------------------------
+
+void mirror_lossless(bool wait)
+{
+  mirror_wait = wait;
+}
+
+//----------------------------------------
+// Send a marker, the screen is complete up to here.
+//     id    number for the host
+//     name  short name for the host, at most 255 characters
+//
+// Not sent if damage was dropped since the last full frame, as the
+// screen on the host isn't complete.
+//----------------------------------------
+
+void mirror_marker(uint16_t id, const char *name)
+{
+  if (!mirror_on)
+    return;
+
+  int len = strlen(name);
+
+  tile_flush();
+  if (mirror_full)
+  {
+    DEBUG("mirror_marker: damage dropped, marker %d not sent\n", id);
+    return;
+  }
+  mirror_begin();
+  mirror_byte(MIRROR_SYNC1);
+  mirror_byte(MIRROR_SYNC2);
+  mirror_byte('M');
+  mirror_u16(id);
+  mirror_byte(len);
+  for (int i = 0; i < len; ++i)
+    mirror_byte(name[i]);
+  mirror_end();
+}
+
+//----------------------------------------
+// Send buffered mirror data and start a full frame if needed.
+// Returns 'true' if the caller must redraw the whole screen.
+//
+// Only call this where the whole screen can be redrawn.
+//----------------------------------------
+
+bool mirror_poll(void)
+{
+  if (!mirror_on)
+    return false;
+
+  console_drain();
+
+  // start a full frame once the backlog has gone
+  if (mirror_full && (console_pending() == 0))
+  {
+    mirror_full = false;
+    mirror_begin();
+    mirror_byte(MIRROR_SYNC1);
+    mirror_byte(MIRROR_SYNC2);
+    mirror_byte('F');
+    mirror_u16(tft.width());
+    mirror_u16(tft.height());
+    mirror_end();
+    return true;
+  }
+
+  return false;
+}
+
+// build the display class for the fitted panel
+template class MirrorTFT<TFTPanel>;
@@ -0,0 +1,90 @@
+#ifndef MIRROR_H
+#define MIRROR_H
+
+////////////////////////////////////////////////////////////////////////////////
+// Screen mirroring over the USB serial port.
+//
+// MirrorTFT is the display driver with its drawing primitives hooked.  It
+// is a template on the panel traits in panel.h, built for TFTPanel.  When
+// mirroring is on, every change to the screen is sent to the host as a
+// rectangle of RLE-compressed RGB565 pixels.  Solid fills become a single
+// run.  Pixels drawn one at a time (font glyphs, lines, circles) are
+// gathered in a small tile and sent as one rectangle, with "skip" runs
+// for pixels that weren't drawn.
+//
+// The stream format, all values little-endian:
+//
+//     0xA5 0x5A 'F' w:u16 h:u16                 start of a full frame
+//     0xA5 0x5A 'R' x:u16 y:u16 w:u16 h:u16     rectangle, followed by runs
+//         n:u16 color:u16                       run of 'n' pixels
+//         (0x8000|n):u16                        skip 'n' pixels
+//     0xA5 0x5A 'M' id:u16 n:u8 name[n]         marker, see snapshot.h
+//
+// Runs fill the rectangle left to right, top to bottom.
+//
+// The encoded stream goes into the console ring buffer, see console.h, as
+// whole messages between any other output.  Mirroring never waits for the
+// host.  If the buffer fills, the damage is dropped and a full frame is sent
+// by mirror_poll() once the buffer has drained.  While mirror_lossless(true)
+// is in force drawing waits for the host instead, for up to MIRROR_WAIT_MS.
+//
+// MirrorTFT also sends large solid fills through the DMA fill engine in
+// fill.h.  The end of a write transaction waits for the fill in flush().
+// That happens when the display is next used, or at the next pen_touch().
+// Setting an address window is a preemption point for the SPI bus arbiter
+// in spibus.h.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+#include "panel.h"
+
+#define MIRROR_WAIT_MS      1000    // longest lossless wait for the host (ms)
+#define MIRROR_TILE_W       48      // size of tile gathering single pixels
+#define MIRROR_TILE_H       48
+
+template <class P>
+class MirrorTFT final : public P::Driver
+{
+  public:
+    typedef typename P::Driver Driver;
+
+    MirrorTFT(int8_t cs, int8_t dc, int8_t rst) : Driver(cs, dc, rst) {}
+
+    void startWrite(void) override;
+    void endWrite(void) override;
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+    void writePixel(int16_t x, int16_t y, uint16_t color) override;
+    void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+    void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+    void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+    void fillScreen(uint16_t color) override;
+    void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) override;
+
+    // hides the Adafruit_GFX version, which isn't virtual
+    void fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color);
+
+    // finish any DMA fill, call before using another SPI device
+    void flush(void);
+
+  private:
+    void fill_rect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+
+    int batch = 0;          // depth of startWrite()/endWrite() nesting
+    int depth = 0;          // depth of calls through our own overrides
+    bool end_pending = false;   // endWrite() waiting for a DMA fill
+};
+
+// the display class for the fitted panel, instantiated in mirror.cpp
+typedef MirrorTFT<TFTPanel> PanelTFT;
+
+void mirror_start(void);
+void mirror_stop(void);
+bool mirror_active(void);
+bool mirror_poll(void);
+void mirror_lossless(bool wait);
+void mirror_marker(uint16_t id, const char *name);
+
+#endif
@@ -0,0 +1,89 @@
+////////////////////////////////////////////////////////////////////////////////
+// A detector voltage monitor for PixelVFO.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "PixelVFO.h"
+#include "monitor.h"
+#include "console.h"
+
+StripChart monitor_chart;
+
+static IntervalTimer monitor_timer;
+
+// queue shared with the timer interrupt
+static volatile uint16_t monitor_queue[MONITOR_QUEUE];
+static volatile uint32_t monitor_head = 0;      // written by interrupt
+static volatile uint32_t monitor_tail = 0;      // written by event loop
+static volatile uint32_t monitor_drops = 0;
+
+//----------------------------------------
+// Timer interrupt handler - read the ADC into the queue.
+//----------------------------------------
+
+static void monitor_isr(void)
+{
+  uint32_t head = monitor_head;
+
+  if (head - monitor_tail >= MONITOR_QUEUE)
+  {
+    ++monitor_drops;
+    return;
+  }
+
+  monitor_queue[head & (MONITOR_QUEUE - 1)] = analogRead(MONITOR_PIN);
+  monitor_head = head + 1;
+}
+
+//----------------------------------------
+// Start and stop sampling.
+//----------------------------------------
+
+void monitor_start(void)
+{
+  analogReadResolution(MONITOR_BITS);
+  monitor_head = monitor_tail = 0;
+  monitor_drops = 0;
+  monitor_timer.begin(monitor_isr, (unsigned int) (1000000 / MONITOR_RATE));
+}
+
+void monitor_stop(void)
+{
+  monitor_timer.end();
+}
+
+//----------------------------------------
+// Get the oldest queued sample.
+//     value  address of cell to receive the sample
+// Returns 'false' if the queue is empty.
+//----------------------------------------
+
+bool monitor_get(int32_t *value)
+{
+  uint32_t tail = monitor_tail;
+
+  if (tail == monitor_head)
+    return false;
+
+  *value = monitor_queue[tail & (MONITOR_QUEUE - 1)];
+  monitor_tail = tail + 1;
+  return true;
+}
+
+uint32_t monitor_dropped(void)
+{
+  return monitor_drops;
+}
+
+//----------------------------------------
+// Send the statistics of the last run over the serial port, format in
+// monitor.h.
+//----------------------------------------
+
+void monitor_report(void)
+{
+  console.printf("ZV%lu,%lu,%u,%lu;",
+                 (unsigned long) monitor_chart.samples,
+                 (unsigned long) monitor_chart.pixels,
+                 (unsigned) monitor_chart.max_pixels,
+                 (unsigned long) monitor_drops);
+}
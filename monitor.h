@@ -0,0 +1,36 @@
+#ifndef MONITOR_H
+#define MONITOR_H
+
+////////////////////////////////////////////////////////////////////////////////
+// A detector voltage monitor for PixelVFO.
+//
+// A timer interrupt reads the ADC pin MONITOR_PIN MONITOR_RATE times a
+// second into a small queue.  The event loop takes samples from the queue
+// and plots them on a strip-chart.  If the event loop falls behind, new
+// samples are dropped and counted.
+//
+// The statistics of the last run are sent with the "ZV;" CAT command:
+//
+//     ZVsamples,pixels,max_pixels,dropped;
+//
+// where 'pixels' is the number drawn or erased for all the samples and
+// 'max_pixels' the most for one sample, see stripchart.h.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+#include "stripchart.h"
+
+#define MONITOR_PIN         A0      // ADC input
+#define MONITOR_RATE        200     // samples per second
+#define MONITOR_QUEUE       64      // queue length, power of 2
+#define MONITOR_BITS        10      // ADC resolution
+
+extern StripChart monitor_chart;     // the chart the samples are plotted on
+
+void monitor_start(void);
+void monitor_stop(void);
+bool monitor_get(int32_t *value);
+uint32_t monitor_dropped(void);
+void monitor_report(void);
+
+#endif
@@ -0,0 +1,161 @@
+////////////////////////////////////////////////////////////////////////////////
+// Overlay restore for PixelVFO.
+//
+// The screen beneath an overlay is rebuilt from its widget table, see
+// overlay.h.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "PixelVFO.h"
+#include "overlay.h"
+
+// a screen rectangle
+struct OverlayRect
+{
+  int16_t x;
+  int16_t y;
+  int16_t w;
+  int16_t h;
+};
+
+static const Widget *overlay_widgets = NULL;        // table of screen beneath
+static int overlay_num_widgets = 0;                 // entries in the table
+static OverlayRect overlay_rects[OVERLAY_MAX_RECTS];  // covered rectangles
+static int overlay_num_rects = 0;                   // rectangles covered
+
+//----------------------------------------
+// Check if two rectangles overlap.
+// Returns 'true' if they share any pixel.
+//----------------------------------------
+
+static bool rect_overlap(int ax, int ay, int aw, int ah,
+                         const OverlayRect *b)
+{
+  return (ax < b->x + b->w) && (b->x < ax + aw) &&
+         (ay < b->y + b->h) && (b->y < ay + ah);
+}
+
+//----------------------------------------
+// Grow a rectangle to also hold a widget.
+//     rect  the rectangle to grow
+//     wid   the widget
+//----------------------------------------
+
+static void rect_grow(OverlayRect *rect, const Widget *wid)
+{
+  int x2 = max(rect->x + rect->w, wid->x + wid->w);
+  int y2 = max(rect->y + rect->h, wid->y + wid->h);
+
+  rect->x = min((int) rect->x, (int) wid->x);
+  rect->y = min((int) rect->y, (int) wid->y);
+  rect->w = x2 - rect->x;
+  rect->h = y2 - rect->y;
+}
+
+//----------------------------------------
+// Register the widgets of the screen just drawn.
+//     widgets  address of the widget table, NULL if none
+//     num      number of widgets in the table
+//----------------------------------------
+
+void overlay_screen(const Widget *widgets, int num)
+{
+  overlay_widgets = widgets;
+  overlay_num_widgets = (widgets) ? num : 0;
+}
+
+//----------------------------------------
+// Start an overlay, call before overlay_cover().
+//----------------------------------------
+
+void overlay_open(void)
+{
+  overlay_num_rects = 0;
+}
+
+//----------------------------------------
+// Note a rectangle the overlay is about to draw over.
+//     x, y, w, h  the rectangle
+//----------------------------------------
+
+void overlay_cover(int x, int y, int w, int h)
+{
+  if (overlay_num_rects >= OVERLAY_MAX_RECTS)
+  {
+    // too many, merge into the last one
+    OverlayRect *last = &overlay_rects[OVERLAY_MAX_RECTS - 1];
+    Widget wid = {(int16_t) x, (int16_t) y, (int16_t) w, (int16_t) h, 0, NULL, 0};
+
+    rect_grow(last, &wid);
+    return;
+  }
+
+  overlay_rects[overlay_num_rects++] = {(int16_t) x, (int16_t) y, (int16_t) w, (int16_t) h};
+}
+
+//----------------------------------------
+// Repaint the screen beneath the overlay.
+// Returns 'false' if there is no widget table and nothing was drawn,
+// the caller must redraw the whole screen.
+//----------------------------------------
+
+bool overlay_close(void)
+{
+  int num_rects = overlay_num_rects;
+
+  overlay_num_rects = 0;
+  if (!overlay_widgets)
+    return false;
+
+  OverlayRect damage[OVERLAY_MAX_RECTS];   // grow as widgets are redrawn
+  uint32_t pixels = 0;                      // pixels drawn, for debug
+
+  memcpy(damage, overlay_rects, sizeof(damage));
+
+  // one pass in z-order, so nothing drawn is painted over by a lower widget
+  for (int i = 0; i < overlay_num_widgets; ++i)
+  {
+    const Widget *wid = &overlay_widgets[i];
+
+    if (!wid->draw)
+    {
+      // background, fill just the covered parts
+      for (int r = 0; r < num_rects; ++r)
+      {
+        const OverlayRect *cover = &overlay_rects[r];
+
+        if (!rect_overlap(wid->x, wid->y, wid->w, wid->h, cover))
+          continue;
+
+        int x = max((int) wid->x, (int) cover->x);
+        int y = max((int) wid->y, (int) cover->y);
+        int w = min(wid->x + wid->w, cover->x + cover->w) - x;
+        int h = min(wid->y + wid->h, cover->y + cover->h) - y;
+
+        tft.fillRect(x, y, w, h, wid->bg);
+        pixels += w * h;
+      }
+      continue;
+    }
+
+    // the widget draws its whole area, which widgets above must then cover
+    bool redraw = false;
+
+    for (int r = 0; r < num_rects; ++r)
+    {
+      if (rect_overlap(wid->x, wid->y, wid->w, wid->h, &damage[r]))
+      {
+        rect_grow(&damage[r], wid);
+        redraw = true;
+      }
+    }
+
+    if (redraw)
+    {
+      wid->draw(wid->arg);
+      pixels += wid->w * wid->h;
+    }
+  }
+
+  DEBUG("overlay_close: %d rects, %lu pixels\n", num_rects, (unsigned long) pixels);
+  return true;
+}
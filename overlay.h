@@ -0,0 +1,48 @@
+#ifndef OVERLAY_H
+#define OVERLAY_H
+
+////////////////////////////////////////////////////////////////////////////////
+// Overlay restore for PixelVFO.
+//
+// The keypad and the dialogs are drawn over the screen beneath them.  There
+// isn't the RAM to save the pixels under them (a 260x200 dialog is 104KB
+// of RGB565), so instead the screen beneath is rebuilt from a table of the
+// widgets it is made of.
+//
+// A screen registers its widget table with overlay_screen() when it draws
+// itself.  The table is in z-order, bottom first.  A widget with a NULL
+// 'draw' function is a plain background.  An overlay calls overlay_open(),
+// notes each rectangle it covers with overlay_cover(), then draws itself.
+// overlay_close() repaints each covered rectangle: backgrounds are filled
+// just inside the rectangle, and every widget touching the rectangle is
+// redrawn, as is any widget above that touches a redrawn one.  Nothing
+// outside the covered rectangles and the widgets that touch them is drawn.
+//
+// A screen that draws itself without a widget table must call
+// overlay_screen(NULL, 0) before showing an overlay, so overlay_close()
+// returns 'false' and the caller redraws the whole screen as before.
+// Overlays don't nest.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+
+#define OVERLAY_MAX_RECTS   4       // most rectangles one overlay can cover
+
+// one widget of a screen
+struct Widget
+{
+  int16_t x;                  // screen area of the widget
+  int16_t y;
+  int16_t w;
+  int16_t h;
+  uint16_t bg;                // background colour, used if 'draw' is NULL
+  void (*draw)(int arg);      // draws the whole widget, NULL if background
+  int arg;                    // arg for 'draw'
+};
+
+void overlay_screen(const Widget *widgets, int num);
+void overlay_open(void);
+void overlay_cover(int x, int y, int w, int h);
+bool overlay_close(void);
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef PANEL_H
+#define PANEL_H
+
+////////////////////////////////////////////////////////////////////////////////
+// Display panel selection for PixelVFO.
+//
+// Define PANEL_TYPE as the panel fitted, the default is the ILI9341.  Each
+// panel has a traits struct giving the Adafruit driver class, the screen
+// size after rotation, the rotation, the SPI clock and the bytes per pixel
+// on the bus.  The display class MirrorTFT in mirror.h is a template on the
+// traits and is 'final', so every call through 'tft' is resolved when the
+// sketch is compiled.  Only the selected panel's driver is compiled in.
+//
+// The screen size is a compile-time constant, SCREEN_WIDTH x SCREEN_HEIGHT.
+// The ILI9341_* colour names are plain RGB565 values, they are defined here
+// for the other panels.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+
+#define PANEL_ILI9341   1       // 320x240, 16 bit pixels
+#define PANEL_ST7789    2       // 320x240, 16 bit pixels
+#define PANEL_ILI9488   3       // 480x320, 18 bit pixels over SPI
+
+#ifndef PANEL_TYPE
+#define PANEL_TYPE      PANEL_ILI9341
+#endif
+
+// traits of each panel, only the selected one is defined
+template <int Type> struct Panel;
+
+#if PANEL_TYPE == PANEL_ILI9341
+
+#include <Adafruit_ILI9341.h>
+
+template <> struct Panel<PANEL_ILI9341>
+{
+  typedef Adafruit_ILI9341 Driver;
+  static constexpr int16_t width = 320;
+  static constexpr int16_t height = 240;
+  static constexpr uint8_t rotation = 1;
+  static constexpr uint32_t clock = 24000000;
+  static constexpr uint8_t pixel_bytes = 2;
+
+  static void begin(Driver &tft) { tft.begin(clock); }
+};
+
+#elif PANEL_TYPE == PANEL_ST7789
+
+#include <Adafruit_ST7789.h>
+
+template <> struct Panel<PANEL_ST7789>
+{
+  typedef Adafruit_ST7789 Driver;
+  static constexpr int16_t width = 320;
+  static constexpr int16_t height = 240;
+  static constexpr uint8_t rotation = 1;
+  static constexpr uint32_t clock = 24000000;
+  static constexpr uint8_t pixel_bytes = 2;
+
+  static void begin(Driver &tft) { tft.init(height, width); tft.setSPISpeed(clock); }
+};
+
+#elif PANEL_TYPE == PANEL_ILI9488
+
+#include <Adafruit_ILI9488.h>
+
+template <> struct Panel<PANEL_ILI9488>
+{
+  typedef Adafruit_ILI9488 Driver;
+  static constexpr int16_t width = 480;
+  static constexpr int16_t height = 320;
+  static constexpr uint8_t rotation = 1;
+  static constexpr uint32_t clock = 20000000;
+  static constexpr uint8_t pixel_bytes = 3;
+
+  static void begin(Driver &tft) { tft.begin(clock); }
+};
+
+#else
+#error "PANEL_TYPE must be PANEL_ILI9341, PANEL_ST7789 or PANEL_ILI9488"
+#endif
+
+typedef Panel<PANEL_TYPE> TFTPanel;
+
+#define SCREEN_WIDTH    (TFTPanel::width)
+#define SCREEN_HEIGHT   (TFTPanel::height)
+
+#if PANEL_TYPE != PANEL_ILI9341
+// RGB565 colours and the standard display on/off commands
+#define ILI9341_BLACK       0x0000
+#define ILI9341_NAVY        0x000F
+#define ILI9341_DARKGREEN   0x03E0
+#define ILI9341_DARKGREY    0x7BEF
+#define ILI9341_BLUE        0x001F
+#define ILI9341_GREEN       0x07E0
+#define ILI9341_CYAN        0x07FF
+#define ILI9341_RED         0xF800
+#define ILI9341_MAGENTA     0xF81F
+#define ILI9341_YELLOW      0xFFE0
+#define ILI9341_WHITE       0xFFFF
+#define ILI9341_ORANGE      0xFD20
+#define ILI9341_DISPOFF     0x28
+#define ILI9341_DISPON      0x29
+#endif
+
+#endif
@@ -0,0 +1,159 @@
+////////////////////////////////////////////////////////////////////////////////
+// Profiling zones for PixelVFO.
+//
+// The "Profile" item in the Settings menu writes a table to the console,
+// the "ZP;" CAT command sends one record per zone.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "PixelVFO.h"
+#include "profile.h"
+#include "utils.h"
+#include "console.h"
+
+#if !defined(__arm__)
+#include <chrono>
+#endif
+
+#ifdef PROFILE_ENABLE
+static ProfileStats profile_stats[PZ_NumZones];
+
+// display names of the zones, same order as ProfileZone
+static const char *profile_names[PZ_NumZones] =
+{
+  "freq_show",
+  "draw_screen",
+  "menu_draw",
+  "util_button",
+  "keypad_show",
+  "pen_touch",
+  "slot_get",
+  "slot_put",
+  "backup_commit",
+};
+
+//----------------------------------------
+// Get the current cycle count.
+//----------------------------------------
+
+uint32_t profile_now(void)
+{
+#if defined(__arm__)
+  return ARM_DWT_CYCCNT;
+#else
+  return (uint32_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+//----------------------------------------
+// Add one call to a zone's statistics.
+//     zone    the zone
+//     cycles  cycles taken by the call
+//----------------------------------------
+
+void profile_record(ProfileZone zone, uint32_t cycles)
+{
+  ProfileStats *stats = &profile_stats[zone];
+
+  ++stats->calls;
+  stats->total += cycles;
+  if (cycles < stats->min)
+    stats->min = cycles;
+  if (cycles > stats->max)
+    stats->max = cycles;
+}
+#endif
+
+//----------------------------------------
+// Start the cycle counter and clear the statistics.
+//----------------------------------------
+
+void profile_init(void)
+{
+#if defined(PROFILE_ENABLE) && defined(__arm__)
+  ARM_DEMCR |= ARM_DEMCR_TRCENA;
+  ARM_DWT_CTRL |= ARM_DWT_CTRL_CYCCNTENA;
+#endif
+  profile_reset();
+}
+
+void profile_reset(void)
+{
+#ifdef PROFILE_ENABLE
+  for (int i = 0; i < PZ_NumZones; ++i)
+  {
+    profile_stats[i].calls = 0;
+    profile_stats[i].total = 0;
+    profile_stats[i].min = 0xFFFFFFFF;
+    profile_stats[i].max = 0;
+  }
+#endif
+}
+
+//----------------------------------------
+// Send the statistics to the console as CAT records, one per zone:
+//     ZPz,calls,total,min,max;
+// with 'z' the ProfileZone number.  'min' is 0 for a zone never entered.
+//----------------------------------------
+
+void profile_report(void)
+{
+#ifdef PROFILE_ENABLE
+  for (int i = 0; i < PZ_NumZones; ++i)
+  {
+    ProfileStats *stats = &profile_stats[i];
+
+    console.printf("ZP%d,%lu,%lu,%lu,%lu;", i, (unsigned long) stats->calls,
+                   (unsigned long) stats->total,
+                   (unsigned long) ((stats->calls) ? stats->min : 0),
+                   (unsigned long) stats->max);
+  }
+#endif
+}
+
+//----------------------------------------
+// Write the statistics to the console as a table.
+//----------------------------------------
+
+static void profile_table(void)
+{
+#ifdef PROFILE_ENABLE
+  console.printf("~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n");
+#if defined(__arm__)
+  console.printf("Profile (cycles at %ldMHz):\n", F_CPU / 1000000L);
+#else
+  console.printf("Profile (nanoseconds):\n");
+#endif
+  console.printf("  %-12s %8s %12s %10s %10s %10s\n", "zone", "calls", "total", "mean", "min", "max");
+  for (int i = 0; i < PZ_NumZones; ++i)
+  {
+    ProfileStats *stats = &profile_stats[i];
+
+    if (stats->calls == 0)
+    {
+      console.printf("  %-12s %8d\n", profile_names[i], 0);
+      continue;
+    }
+    console.printf("  %-12s %8lu %12lu %10lu %10lu %10lu\n",
+                  profile_names[i], (unsigned long) stats->calls,
+                  (unsigned long) stats->total,
+                  (unsigned long) (stats->total / stats->calls),
+                  (unsigned long) stats->min, (unsigned long) stats->max);
+  }
+  console.printf("~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n");
+#else
+  console.printf("Profiling not enabled, define PROFILE_ENABLE in profile.h\n");
+#endif
+}
+
+//----------------------------------------
+// Settings - write the profile table and reset the statistics.
+//----------------------------------------
+
+bool action_profile(int ignore)
+{
+  profile_table();
+  profile_reset();
+  util_alert("Profile sent to Serial.");
+  return false;   // menu restored under the alert
+}
@@ -0,0 +1,72 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+////////////////////////////////////////////////////////////////////////////////
+// Profiling zones for PixelVFO.
+//
+// Put PROFILE_ZONE(zone) at the top of a function to count its calls and
+// the cycles spent in it.  On the Teensy the Cortex-M DWT cycle counter is
+// used, on other targets std::chrono is used and "cycles" are nanoseconds.
+//
+// Unless PROFILE_ENABLE is defined, PROFILE_ZONE() compiles to nothing.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+
+//#define PROFILE_ENABLE
+
+// the profiled zones
+enum ProfileZone
+{
+  PZ_FreqShow,
+  PZ_DrawScreen,
+  PZ_MenuDraw,
+  PZ_UtilButton,
+  PZ_KeypadShow,
+  PZ_PenTouch,
+  PZ_SlotGet,
+  PZ_SlotPut,
+  PZ_BackupCommit,
+  PZ_NumZones       // must be last
+};
+
+// statistics for one zone
+struct ProfileStats
+{
+  uint32_t calls;       // number of times zone entered
+  uint64_t total;       // total cycles in zone
+  uint32_t min;         // least cycles in one call
+  uint32_t max;         // most cycles in one call
+};
+
+#ifdef PROFILE_ENABLE
+
+uint32_t profile_now(void);
+void profile_record(ProfileZone zone, uint32_t cycles);
+
+// records the cycles between construction and destruction
+class ProfileScope
+{
+  public:
+    ProfileScope(ProfileZone zone) : zone(zone), start(profile_now()) {}
+    ~ProfileScope() { profile_record(zone, profile_now() - start); }
+
+  private:
+    ProfileZone zone;
+    uint32_t start;
+};
+
+#define PROFILE_ZONE(zone)    ProfileScope profile_scope_(zone)
+
+#else
+
+#define PROFILE_ZONE(zone)    do {} while (0)
+
+#endif
+
+void profile_init(void);
+void profile_reset(void);
+void profile_report(void);
+bool action_profile(int);
+
+#endif
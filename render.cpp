@@ -0,0 +1,91 @@
+////////////////////////////////////////////////////////////////////////////////
+// Frame pacing for the PixelVFO main screen.
+//
+// The drawing functions are the ones the handlers used to call directly,
+// see render.h.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "PixelVFO.h"
+#include "render.h"
+#include "bandplan.h"
+
+static uint8_t render_dirty = 0;            // parts marked since last frame
+static uint8_t render_mask = RD_ALL;        // parts the last tick could draw
+static unsigned long render_last = 0;       // millis() at last frame
+
+//----------------------------------------
+// Mark parts of the main screen to be redrawn at the next frame.
+//     parts  RD_* bits
+//----------------------------------------
+
+void render_mark(uint8_t parts)
+{
+  render_dirty |= parts;
+}
+
+//----------------------------------------
+// Check for a frame waiting to be drawn.
+// Returns 'true' if parts the event loop draws are still marked.
+//----------------------------------------
+
+bool render_pending(void)
+{
+  return render_dirty & render_mask;
+}
+
+//----------------------------------------
+// Draw the whole main screen from the VFO state, now.
+//----------------------------------------
+
+void render_screen(void)
+{
+  draw_screen();
+  freq_to_buff(freq_display, frequency);
+  freq_show();
+  band_draw(true);
+}
+
+//----------------------------------------
+// Draw a frame if one is due, call from every pass of an event loop.
+//     mask  RD_* bits of the parts this event loop may draw
+//
+// Marked parts outside 'mask' stay marked.
+//----------------------------------------
+
+void render_tick(uint8_t mask)
+{
+  uint8_t parts = render_dirty & mask;
+
+  render_mask = mask;
+  if (!parts || (millis() - render_last < RENDER_PERIOD_MS))
+    return;
+
+  render_last = millis();
+  render_dirty &= ~parts;
+
+  if (parts & RD_SCREEN)
+  {
+    render_screen();
+    return;
+  }
+
+  if (parts & RD_SELECT)
+  {
+    freq_to_buff(freq_display, frequency);
+    freq_show(freq_digit_select);
+  }
+  else if (parts & RD_FREQ)
+  {
+    char display[NUM_F_CHAR];
+
+    freq_to_buff(display, frequency);
+    freq_update(display);
+  }
+
+  if (parts & RD_ONLINE)
+    drawOnline();
+  if (parts & RD_AB)
+    drawABButton();
+  if (parts & RD_BAND)
+    band_draw(false);   // only if band changed
+}
@@ -0,0 +1,46 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+////////////////////////////////////////////////////////////////////////////////
+// Frame pacing for the PixelVFO main screen.
+//
+// Input on the main screen (touch, keypad, encoder and CAT) only changes the
+// VFO state and marks the parts of the screen to redraw with render_mark().
+// render_tick(), called from the main and keypad event loops, draws the
+// marked parts from the latest state at most once every RENDER_PERIOD_MS.
+// A burst of input between two frames costs one redraw.  If the last frame
+// is older than the period the new one is drawn at once, so a single touch
+// isn't delayed.
+//
+// The digits on the screen are in 'freq_display'.  RD_FREQ redraws just the
+// digits that differ from 'frequency', RD_SELECT redraws them all with the
+// selected digit highlighted.  The keypad edits 'freq_display' itself and
+// marks RD_SELECT.
+//
+// Only the main screen is paced.  Menus, dialogs and the full-screen
+// actions draw directly in their own event loops.  Marks made meanwhile
+// wait until the main screen is back.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+
+#ifndef RENDER_HZ
+#define RENDER_HZ           50      // most frames per second
+#endif
+#define RENDER_PERIOD_MS    (1000 / RENDER_HZ)
+
+// parts of the main screen, bits for render_mark()
+#define RD_FREQ     0x01    // frequency digits that changed
+#define RD_SELECT   0x02    // all frequency digits and the selection
+#define RD_ONLINE   0x04    // ONLINE/standby button
+#define RD_AB       0x08    // A/B button
+#define RD_BAND     0x10    // band indicator, if the band changed
+#define RD_SCREEN   0x20    // the whole screen
+#define RD_ALL      0x3F
+
+void render_mark(uint8_t parts);
+void render_tick(uint8_t mask);
+bool render_pending(void);
+void render_screen(void);
+
+#endif
@@ -0,0 +1,185 @@
+////////////////////////////////////////////////////////////////////////////////
+// A memory slot scanner for PixelVFO.
+//
+// Two ScanChannel buffers are used.  One holds the slot on air, the other is
+// filled with the next non-empty slot while the current one dwells.  The
+// timer handler only swaps buffers and loads the precomputed DDS word.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "scan.h"
+#include "dds.h"
+#include "eeprom.h"
+
+unsigned long scan_dwell = 2000;
+
+static ScanChannel scan_chan[2];
+
+// state shared with the timer interrupt
+static volatile int scan_cur = 0;             // index of scan_chan[] on air
+static volatile bool scan_next_ready = false; // other scan_chan[] is loaded
+static volatile bool scan_switched = false;   // switched, display is stale
+
+static IntervalTimer scan_timer;
+static bool scan_active = false;
+static bool scan_is_paused = false;
+
+//----------------------------------------
+// Timer interrupt handler - put the preloaded slot on air.
+//----------------------------------------
+
+static void scan_isr(void)
+{
+  if (!scan_next_ready)
+    return;           // still preloading, stay where we are
+
+  int next = scan_cur ^ 1;
+
+  if (vfo_state == VFO_Online)
+    dds_load_word(scan_chan[next].word);
+
+  scan_cur = next;
+  scan_next_ready = false;
+  scan_switched = true;
+}
+
+//----------------------------------------
+// Fill a ScanChannel with the first non-empty slot after a given slot.
+//     chan  address of the ScanChannel to fill
+//     slot  slot number to start searching after
+// Returns 'false' if all slots are empty.
+//----------------------------------------
+
+static bool scan_load(ScanChannel *chan, int slot)
+{
+  for (int i = 1; i <= NumSaveSlots; ++i)
+  {
+    int num = (slot + i) % NumSaveSlots;
+    Frequency freq;
+    SelOffset offset;
+
+    slot_get(num, freq, offset);
+    if (freq > 0)
+    {
+      chan->slot = num;
+      chan->freq = freq;
+      chan->offset = offset;
+      chan->word = dds_word(freq);
+      freq_to_buff(chan->display, freq);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+//----------------------------------------
+// Start scanning from the first non-empty slot.
+// Returns 'false' if there is nothing to scan.
+//----------------------------------------
+
+bool scan_begin(void)
+{
+  if (scan_active)
+    return true;
+
+  if (!scan_load(&scan_chan[0], NumSaveSlots - 1))
+  {
+    DEBUG("scan_begin: no saved slots\n");
+    return false;
+  }
+
+  scan_cur = 0;
+  scan_switched = true;
+  if (vfo_state == VFO_Online)
+    dds_load_word(scan_chan[0].word);
+
+  scan_next_ready = scan_load(&scan_chan[1], scan_chan[0].slot);
+
+  scan_active = true;
+  scan_is_paused = false;
+  scan_timer.begin(scan_isr, (unsigned int) (scan_dwell * 1000));
+  DEBUG("scan_begin: started at slot %d, dwell=%ldms\n", scan_chan[0].slot, scan_dwell);
+  return true;
+}
+
+//----------------------------------------
+// Stop scanning.  The VFO is left on the current slot.
+//----------------------------------------
+
+void scan_end(void)
+{
+  if (!scan_active)
+    return;
+
+  scan_timer.end();
+  scan_active = false;
+  scan_is_paused = false;
+
+  const ScanChannel *chan = scan_channel();
+  frequency = chan->freq;
+  freq_digit_select = chan->offset;
+  DEBUG("scan_end: stopped at slot %d\n", chan->slot);
+}
+
+//----------------------------------------
+// Pause and resume the scan.
+// On resume the current slot gets a full dwell period.
+//----------------------------------------
+
+void scan_pause(void)
+{
+  if (scan_active && !scan_is_paused)
+  {
+    scan_timer.end();
+    scan_is_paused = true;
+  }
+}
+
+void scan_resume(void)
+{
+  if (scan_active && scan_is_paused)
+  {
+    scan_timer.begin(scan_isr, (unsigned int) (scan_dwell * 1000));
+    scan_is_paused = false;
+  }
+}
+
+bool scan_paused(void)
+{
+  return scan_is_paused;
+}
+
+//----------------------------------------
+// Service the scanner from an event loop.
+// Returns 'true' if the slot on air changed since the last call.
+//
+// After a switch the next slot is preloaded before returning, so the
+// caller's display update doesn't delay the next switch.
+//----------------------------------------
+
+bool scan_poll(void)
+{
+  if (!scan_active || !scan_switched)
+    return false;
+
+  scan_switched = false;
+
+  if (!scan_next_ready)
+  {
+    int cur = scan_cur;
+
+    if (scan_load(&scan_chan[cur ^ 1], scan_chan[cur].slot))
+      scan_next_ready = true;
+  }
+
+  return true;
+}
+
+//----------------------------------------
+// Returns the address of the ScanChannel on air.
+//----------------------------------------
+
+const ScanChannel *scan_channel(void)
+{
+  return &scan_chan[scan_cur];
+}
@@ -0,0 +1,35 @@
+#ifndef SCAN_H
+#define SCAN_H
+
+////////////////////////////////////////////////////////////////////////////////
+// A memory slot scanner for PixelVFO.
+//
+// The scanner steps through the saved slots, skipping empty ones, and stays
+// on each slot for the dwell time.  The switch to the next slot is done from
+// a timer interrupt, the display is updated later from the event loop.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+#include "PixelVFO.h"
+
+// a slot being scanned, everything needed to put it on air and display it
+struct ScanChannel
+{
+  int slot;                     // slot number
+  Frequency freq;               // slot frequency
+  SelOffset offset;             // slot selected digit
+  uint32_t word;                // DDS tuning word for 'freq'
+  char display[NUM_F_CHAR];     // frequency display digits for 'freq'
+};
+
+extern unsigned long scan_dwell;    // time on each slot (milliseconds)
+
+bool scan_begin(void);
+void scan_end(void);
+void scan_pause(void);
+void scan_resume(void);
+bool scan_paused(void);
+bool scan_poll(void);
+const ScanChannel *scan_channel(void);
+
+#endif
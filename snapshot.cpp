@@ -0,0 +1,203 @@
+////////////////////////////////////////////////////////////////////////////////
+// Screen snapshots for PixelVFO.
+//
+// The scenarios and their numbering are described in snapshot.h.  Each
+// one draws with the same functions the event loops use.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "PixelVFO.h"
+#include "snapshot.h"
+#include "mirror.h"
+#include "render.h"
+#include "bandplan.h"
+#include "utils.h"
+
+// the scenarios after the menus, in order
+static const char *const snapshot_last[] =
+{
+  "alert",
+  "confirm",
+  "credits",
+  "abort",
+};
+
+#define SnapshotLastLen   ALEN(snapshot_last)
+
+// number of the first keypad and menu scenarios, the main screen is 0
+#define SNAPSHOT_FIRST_KEYPAD   1
+#define SNAPSHOT_FIRST_MENU     (SNAPSHOT_FIRST_KEYPAD + NUM_F_CHAR)
+
+static const Menu *snapshot_root = NULL;  // menu the menu scenarios start at
+
+//----------------------------------------
+// Set the menu tree to draw.
+//     root  address of the main menu
+//----------------------------------------
+
+void snapshot_init(const Menu *root)
+{
+  snapshot_root = root;
+}
+
+//----------------------------------------
+// Get the number of scroll positions of a menu.
+//     menu  address of the menu
+//----------------------------------------
+
+static int menu_positions(const Menu *menu)
+{
+  return max(1, menu->num_items - MAXMENUITEMROWS + 1);
+}
+
+//----------------------------------------
+// Count the menu scenarios of a menu and all its submenus.
+//     menu  address of the menu
+//----------------------------------------
+
+static int menu_count(const Menu *menu)
+{
+  int count = menu_positions(menu);
+
+  for (int i = 0; i < menu->num_items; ++i)
+    if (menu->items[i].menu)
+      count += menu_count(menu->items[i].menu);
+
+  return count;
+}
+
+//----------------------------------------
+// Find a menu scenario, depth first from a menu.
+//     menu    address of the menu to search from
+//     num     the scenario within this tree, reduced by those passed over
+//     cursor  address of cursor to fill in
+// Returns 'true' if the scenario was found.
+//----------------------------------------
+
+static bool menu_find(const Menu *menu, int &num, MenuCursor *cursor)
+{
+  if (num < menu_positions(menu))
+  {
+    cursor->menu = menu;
+    cursor->top = num;
+    return true;
+  }
+  num -= menu_positions(menu);
+
+  for (int i = 0; i < menu->num_items; ++i)
+    if (menu->items[i].menu && menu_find(menu->items[i].menu, num, cursor))
+      return true;
+
+  return false;
+}
+
+//----------------------------------------
+// Get the number of menu scenarios.
+//----------------------------------------
+
+static int snapshot_menus(void)
+{
+  return (snapshot_root) ? menu_count(snapshot_root) : 0;
+}
+
+//----------------------------------------
+// Get the number of scenarios.
+//----------------------------------------
+
+int snapshot_count(void)
+{
+  return SNAPSHOT_FIRST_MENU + snapshot_menus() + SnapshotLastLen;
+}
+
+//----------------------------------------
+// Draw one scenario into the mirror stream.
+//     num  the scenario number
+// Returns 'false' if 'num' is bad or mirroring is off.
+//----------------------------------------
+
+bool snapshot_take(int num)
+{
+  if (!mirror_active() || (num < 0) || (num >= snapshot_count()))
+    return false;
+
+  // the fixed state every scenario shows
+  Frequency freq = frequency;
+  SelOffset select = freq_digit_select;
+  VFOState state = vfo_state;
+  int active = vfo_active;
+  bool split = vfo_split;
+
+  frequency = SNAPSHOT_FREQ;
+  freq_digit_select = -1;
+  vfo_state = VFO_Standby;
+  vfo_active = VFO_A;
+  vfo_split = false;
+  band_check(frequency);
+
+  char name[SNAPSHOT_NAME_MAX];
+  int first_last = SNAPSHOT_FIRST_MENU + snapshot_menus();
+
+  mirror_lossless(true);
+  tft.fillScreen(ILI9341_BLACK);    // nothing left from the last scenario
+
+  if (num < SNAPSHOT_FIRST_KEYPAD)
+  {
+    strcpy(name, "main");
+    render_screen();
+  }
+  else if (num < SNAPSHOT_FIRST_MENU)
+  {
+    int digit = num - SNAPSHOT_FIRST_KEYPAD;
+
+    sprintf(name, "keypad%d", digit);
+    render_screen();
+    keypad_draw(digit);
+  }
+  else if (num < first_last)
+  {
+    int n = num - SNAPSHOT_FIRST_MENU;
+    MenuCursor cursor;
+
+    menu_find(snapshot_root, n, &cursor);
+    snprintf(name, sizeof(name), "menu-%s-%d", cursor.menu->title, cursor.top);
+    menu_draw(&cursor);
+  }
+  else
+  {
+    int n = num - first_last;
+
+    strcpy(name, snapshot_last[n]);
+    switch (n)
+    {
+      case 0:
+        render_screen();
+        draw_alert("Snapshot alert, a message long enough to wrap.");
+        break;
+      case 1:
+        render_screen();
+        draw_confirm("Snapshot confirm?");
+        break;
+      case 2:
+        credits_draw();
+        break;
+      case 3:
+        abort_draw("Snapshot abort");
+        break;
+    }
+  }
+
+  mirror_marker(num, name);
+  mirror_lossless(false);
+
+  // back to the real state and the main screen, now, so its widget table
+  // is the one registered before the next touch
+  frequency = freq;
+  freq_digit_select = select;
+  vfo_state = state;
+  vfo_active = active;
+  vfo_split = split;
+  band_check(frequency);
+  render_screen();
+
+  DEBUG("snapshot_take: scenario %d '%s' drawn\n", num, name);
+  return true;
+}
@@ -0,0 +1,45 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+////////////////////////////////////////////////////////////////////////////////
+// Screen snapshots for PixelVFO.
+//
+// A snapshot draws one screen in a known state, its "scenario", into the
+// screen mirror stream, see mirror.h.  The scenarios are numbered:
+//
+//     main screen
+//     keypad, one for each selected digit
+//     every menu reachable from the main menu, at every scroll position
+//     alert dialog, confirm dialog, credits, abort
+//
+// Each snapshot starts by clearing the screen, so its part of the stream
+// rebuilds the whole screen on its own.  It ends with a mirror marker that
+// carries the scenario number and a name.  The stream is lossless while a
+// snapshot draws, but if the host stops reading for MIRROR_WAIT_MS the
+// damage is dropped and the marker isn't sent, so the host asks again.
+// The VFO state shown is fixed at SNAPSHOT_FREQ, VFO A, standby and no
+// split, and put back afterwards.  Menu item text that comes from
+// settings is shown as set.
+//
+// The CAT commands, mirroring must be on for "ZTnnn;":
+//
+//     ZT;          reply ZTnnn;  number of scenarios
+//     ZTnnn;       draw scenario nnn, no reply, the marker is the reply
+//
+// The main screen is redrawn before snapshot_take() returns, so the main
+// event loop's screen and widget table are back before the next touch.  The host side is
+// tools/snapshot_check.py, which compares the screens with saved images.
+// tests/test_snapshot.cpp checks them the same way without a VFO.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+#include "menu.h"
+
+#define SNAPSHOT_FREQ       7100000     // frequency shown in every scenario
+#define SNAPSHOT_NAME_MAX   32          // longest scenario name, with '\0'
+
+void snapshot_init(const struct Menu *root);
+int snapshot_count(void);
+bool snapshot_take(int num);
+
+#endif
@@ -0,0 +1,133 @@
+////////////////////////////////////////////////////////////////////////////////
+// SPI bus arbiter for PixelVFO.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "PixelVFO.h"
+#include "spibus.h"
+#include "console.h"
+
+SpiStats spi_stats[SPI_NumDevices];
+SpiJobSlot spi_jobs[SPI_NumDevices];
+
+static unsigned long spi_start[SPI_NumDevices];     // micros() at spi_begin()
+static unsigned long spi_busy_rem[SPI_NumDevices];  // time not yet in 'busy_ms' (us)
+static bool spi_held[SPI_NumDevices];               // 'true' between begin and end
+static unsigned long spi_reset_time;                // millis() at last reset
+
+//----------------------------------------
+// Note that a device has taken the bus.  Nested calls are ignored.
+//     dev  the device
+//----------------------------------------
+
+void spi_begin(SpiDevice dev)
+{
+  if (spi_held[dev])
+    return;
+
+  spi_held[dev] = true;
+  spi_start[dev] = micros();
+  ++spi_stats[dev].transactions;
+}
+
+//----------------------------------------
+// Note that a device has given up the bus.
+//     dev  the device
+//----------------------------------------
+
+void spi_end(SpiDevice dev)
+{
+  if (!spi_held[dev])
+    return;
+
+  unsigned long busy = micros() - spi_start[dev];
+
+  spi_held[dev] = false;
+  if (busy > spi_stats[dev].max_us)
+    spi_stats[dev].max_us = busy;
+  spi_busy_rem[dev] += busy;
+  spi_stats[dev].busy_ms += spi_busy_rem[dev] / 1000;
+  spi_busy_rem[dev] %= 1000;
+}
+
+//----------------------------------------
+// Give a device a periodic job.
+//     dev     the device
+//     job     the job function, NULL to remove the job
+//     period  how often the job is due (milliseconds)
+//----------------------------------------
+
+void spi_job(SpiDevice dev, SpiJob job, unsigned long period)
+{
+  spi_jobs[dev].job = job;
+  spi_jobs[dev].period = period;
+  spi_jobs[dev].last = millis();
+}
+
+//----------------------------------------
+// Run a device's job now, due or not.
+//     dev  the device
+//----------------------------------------
+
+void spi_run(SpiDevice dev)
+{
+  SpiJobSlot *slot = &spi_jobs[dev];
+
+  if (!slot->job)
+    return;
+
+  slot->last = millis();
+  spi_begin(dev);
+  slot->job();
+  spi_end(dev);
+}
+
+//----------------------------------------
+// Run all due jobs of higher priority than the bus holder.  The holder
+// must have ended its SPI transaction, and starts it again after.
+//     holder  the device holding the bus
+//----------------------------------------
+
+void spi_preempt(SpiDevice holder)
+{
+  unsigned long now = millis();
+
+  spi_end(holder);
+  for (int dev = 0; dev < holder; ++dev)
+  {
+    SpiJobSlot *slot = &spi_jobs[dev];
+
+    if (slot->job && (now - slot->last >= slot->period))
+    {
+      ++spi_stats[holder].preempts;
+      spi_run((SpiDevice) dev);
+    }
+  }
+  spi_begin(holder);
+}
+
+//----------------------------------------
+// Send the statistics over the serial port, format in spibus.h.
+//----------------------------------------
+
+void spi_report(void)
+{
+  unsigned long elapsed = millis() - spi_reset_time;
+
+  for (int dev = 0; dev < SPI_NumDevices; ++dev)
+  {
+    SpiStats *stats = &spi_stats[dev];
+
+    console.printf("ZS%d,%lu,%lu,%lu,%lu,%lu;", dev, elapsed,
+                  (unsigned long) stats->transactions,
+                  (unsigned long) stats->busy_ms,
+                  (unsigned long) stats->max_us,
+                  (unsigned long) stats->preempts);
+  }
+}
+
+void spi_reset(void)
+{
+  memset(spi_stats, 0, sizeof(spi_stats));
+  memset(spi_busy_rem, 0, sizeof(spi_busy_rem));
+  spi_reset_time = millis();
+}
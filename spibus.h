@@ -0,0 +1,97 @@
+#ifndef SPIBUS_H
+#define SPIBUS_H
+
+////////////////////////////////////////////////////////////////////////////////
+// SPI bus arbiter for PixelVFO.
+//
+// The display and the XPT2046 touch controller share the hardware SPI bus.
+// The DDS is bit-banged on its own pins (see dds.cpp), so oscillator loads,
+// including the timed sweep steps, never wait for the bus.
+//
+// Devices are listed in priority order, highest first.  A device may have
+// a periodic job, like sampling the touch controller.  Only the display
+// holds the bus for long, so the display driver offers a preemption point
+// each time it sets a new address window.  If a higher priority job is
+// due there, the display transaction is ended, the job runs, and the
+// display transaction starts again.  Large fills are sent in bands of at
+// most SPI_BURST_MAX pixels, so no single burst holds the bus for long.
+//
+// The arbiter only decides who has the bus and when.  Each driver opens
+// its own SPI transaction with its own clock and mode: the XPT2046 library
+// at a fixed 2MHz, mode 0, and the display at TFTPanel::clock, mode 0.
+// Those settings can't be changed from here without changing the drivers.
+//
+// The bus occupancy statistics are sent with the "ZS;" CAT command, one
+// line per device:
+//
+//     ZSd,elapsed_ms,transactions,busy_ms,max_us,preempts;
+//
+// where 'd' is the device number, 'max_us' the longest time the device
+// held the bus and 'preempts' the number of times it gave the bus up to
+// a higher priority job.  "ZS0;" clears the statistics.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+#include <SPI.h>
+
+#define SPI_BURST_MAX   9600        // most pixels in one display burst (~6ms)
+
+// the devices on the bus, highest priority first
+enum SpiDevice
+{
+  SPI_Touch,          // XPT2046 touch controller
+  SPI_Display,        // display panel, see panel.h
+  SPI_NumDevices      // must be last
+};
+
+// bus usage of one device
+struct SpiStats
+{
+  uint32_t transactions;  // times the device took the bus
+  uint32_t busy_ms;       // total time holding the bus (milliseconds)
+  uint32_t max_us;        // longest single hold (microseconds)
+  uint32_t preempts;      // times the device gave way to a higher priority
+};
+
+// a periodic job run by a device
+typedef void (*SpiJob)(void);
+
+struct SpiJobSlot
+{
+  SpiJob job;             // the job, NULL if none
+  unsigned long period;   // how often the job is due (milliseconds)
+  unsigned long last;     // millis() when the job last ran
+};
+
+extern SpiStats spi_stats[SPI_NumDevices];
+extern SpiJobSlot spi_jobs[SPI_NumDevices];
+
+void spi_begin(SpiDevice dev);
+void spi_end(SpiDevice dev);
+void spi_job(SpiDevice dev, SpiJob job, unsigned long period);
+void spi_run(SpiDevice dev);
+void spi_preempt(SpiDevice holder);
+void spi_report(void);
+void spi_reset(void);
+
+//----------------------------------------
+// Check for a job that should preempt the bus holder, called often from
+// the display driver, so it must be quick.
+//     holder  the device holding the bus
+// Returns 'true' if a higher priority job is due.
+//----------------------------------------
+
+inline bool spi_preempt_due(SpiDevice holder)
+{
+  unsigned long now = millis();
+
+  for (int dev = 0; dev < holder; ++dev)
+  {
+    if (spi_jobs[dev].job && (now - spi_jobs[dev].last >= spi_jobs[dev].period))
+      return true;
+  }
+
+  return false;
+}
+
+#endif
@@ -0,0 +1,109 @@
+////////////////////////////////////////////////////////////////////////////////
+// A strip-chart widget for PixelVFO.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "PixelVFO.h"
+#include "stripchart.h"
+
+//----------------------------------------
+// Prepare an empty chart, doesn't draw anything.
+//     chart       address of the chart
+//     x, y, w, h  area on screen, 'w' is cut to CHART_MAX_WIDTH
+//     min, max    value range shown
+//     fg, bg      trace and background colours
+//----------------------------------------
+
+void chart_init(StripChart *chart, int x, int y, int w, int h,
+                int32_t min, int32_t max, uint16_t fg, uint16_t bg)
+{
+  chart->x = x;
+  chart->y = y;
+  chart->w = (w > CHART_MAX_WIDTH) ? CHART_MAX_WIDTH : w;
+  chart->h = h;
+  chart->min = min;
+  chart->max = (max > min) ? max : min + 1;
+  chart->fg = fg;
+  chart->bg = bg;
+  chart->head = 0;
+  chart->last_y = -1;
+  for (int i = 0; i < chart->w; ++i)
+  {
+    chart->top[i] = 1;
+    chart->bot[i] = 0;
+  }
+  chart->samples = 0;
+  chart->pixels = 0;
+  chart->max_pixels = 0;
+}
+
+//----------------------------------------
+// Draw the whole chart, for when the screen has been redrawn.
+//     chart  address of the chart
+//----------------------------------------
+
+void chart_draw(StripChart *chart)
+{
+  tft.fillRect(chart->x, chart->y, chart->w, chart->h, chart->bg);
+  for (int i = 0; i < chart->w; ++i)
+  {
+    if (chart->top[i] <= chart->bot[i])
+      tft.drawFastVLine(chart->x + i, chart->top[i],
+                        chart->bot[i] - chart->top[i] + 1, chart->fg);
+  }
+}
+
+//----------------------------------------
+// Add a sample to the chart, drawing just the columns that change.
+//     chart  address of the chart
+//     value  the sample, clipped to the chart range
+//----------------------------------------
+
+void chart_add(StripChart *chart, int32_t value)
+{
+  int col = chart->head;
+  int ahead = (col + 1 < chart->w) ? col + 1 : 0;
+  uint16_t pixels = 0;
+
+  if (value < chart->min)
+    value = chart->min;
+  if (value > chart->max)
+    value = chart->max;
+
+  int16_t y = chart->y + chart->h - 1
+              - (int16_t) (((int64_t) (value - chart->min) * (chart->h - 1))
+                           / (chart->max - chart->min));
+
+  // this column was erased as the gap last time, draw the new sample,
+  // joined to the previous one unless we just wrapped
+  int16_t top = y;
+  int16_t bot = y;
+
+  if ((chart->last_y >= 0) && (col != 0))
+  {
+    if (chart->last_y < top)
+      top = chart->last_y;
+    if (chart->last_y > bot)
+      bot = chart->last_y;
+  }
+  tft.drawFastVLine(chart->x + col, top, bot - top + 1, chart->fg);
+  pixels += bot - top + 1;
+  chart->top[col] = top;
+  chart->bot[col] = bot;
+
+  // erase the oldest sample, leaving a gap that shows where we are
+  if (chart->top[ahead] <= chart->bot[ahead])
+  {
+    tft.drawFastVLine(chart->x + ahead, chart->top[ahead],
+                      chart->bot[ahead] - chart->top[ahead] + 1, chart->bg);
+    pixels += chart->bot[ahead] - chart->top[ahead] + 1;
+    chart->top[ahead] = 1;
+    chart->bot[ahead] = 0;
+  }
+
+  chart->last_y = y;
+  chart->head = ahead;
+  ++chart->samples;
+  chart->pixels += pixels;
+  if (pixels > chart->max_pixels)
+    chart->max_pixels = pixels;
+}
@@ -0,0 +1,40 @@
+#ifndef STRIPCHART_H
+#define STRIPCHART_H
+
+////////////////////////////////////////////////////////////////////////////////
+// A strip-chart widget for PixelVFO.
+//
+// Samples go into a ring buffer with one entry per chart column.  The
+// chart doesn't scroll its pixels.  Instead the write position moves
+// across the chart and wraps, like a sweeping oscilloscope trace.  Each
+// new sample erases the column ahead of the write position, which holds
+// the oldest sample, and draws the new column as one vertical line joined
+// to the previous sample.  The cost of a sample is at most two lines the
+// height of the chart, however long the chart has been running.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+#include "panel.h"
+
+#define CHART_MAX_WIDTH     SCREEN_WIDTH    // widest chart (pixels)
+
+struct StripChart
+{
+  int16_t x, y, w, h;               // area on screen, inside the frame
+  int32_t min, max;                 // value range, 'min' at the bottom
+  uint16_t fg, bg;                  // trace and background colours
+  int16_t head;                     // column the next sample goes in
+  int16_t last_y;                   // screen Y of the last sample, -1 if none
+  int16_t top[CHART_MAX_WIDTH];     // drawn span of each column, top > bot
+  int16_t bot[CHART_MAX_WIDTH];     // means the column is empty
+  uint32_t samples;                 // samples added
+  uint32_t pixels;                  // pixels drawn or erased for them
+  uint16_t max_pixels;              // most pixels for one sample
+};
+
+void chart_init(StripChart *chart, int x, int y, int w, int h,
+                int32_t min, int32_t max, uint16_t fg, uint16_t bg);
+void chart_draw(StripChart *chart);
+void chart_add(StripChart *chart, int32_t value);
+
+#endif
@@ -0,0 +1,129 @@
+////////////////////////////////////////////////////////////////////////////////
+// A frequency sweep generator for PixelVFO.
+//
+// The sweep runs from an IntervalTimer at the highest interrupt priority.
+// The timer handler does nothing but load the next precomputed tuning word,
+// so the step jitter is bounded by interrupt latency.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "sweep.h"
+#include "dds.h"
+
+// the sweep parameters, with sensible defaults
+Frequency sweep_start_freq = 1000000L;
+Frequency sweep_stop_freq = 2000000L;
+Frequency sweep_step_freq = 1000L;
+unsigned long sweep_dwell = 1000;
+
+// the precomputed tuning words for the sweep
+static uint32_t sweep_table[SWEEP_MAX_STEPS];
+static int sweep_len = 0;                   // number of used entries in table
+
+// state shared with the timer interrupt
+static volatile int sweep_index = 0;        // index of next word to load
+static volatile unsigned long sweep_count = 0;   // number of completed passes
+
+static IntervalTimer sweep_timer;
+static bool sweep_active = false;
+
+//----------------------------------------
+// Timer interrupt handler - load the next step into the DDS.
+//----------------------------------------
+
+static void sweep_isr(void)
+{
+  int ndx = sweep_index;
+
+  dds_load_word(sweep_table[ndx]);
+
+  if (++ndx >= sweep_len)
+  {
+    ndx = 0;
+    ++sweep_count;
+  }
+  sweep_index = ndx;
+}
+
+//----------------------------------------
+// Fill the tuning word table from the sweep parameters.
+// Returns the number of steps in the sweep, 0 if parameters are bad.
+//
+// If the sweep needs more than SWEEP_MAX_STEPS steps it is truncated.
+//----------------------------------------
+
+int sweep_prepare(void)
+{
+  if (sweep_step_freq == 0 || sweep_stop_freq <= sweep_start_freq)
+  {
+    DEBUG("sweep_prepare: bad parameters, start=%ld, stop=%ld, step=%ld\n",
+          sweep_start_freq, sweep_stop_freq, sweep_step_freq);
+    return 0;
+  }
+
+  Frequency freq = sweep_start_freq;
+  int len = 0;
+
+  while ((freq <= sweep_stop_freq) && (len < SWEEP_MAX_STEPS))
+  {
+    sweep_table[len++] = dds_word(freq);
+    freq += sweep_step_freq;
+  }
+
+  sweep_len = len;
+  DEBUG("sweep_prepare: %d steps\n", len);
+  return len;
+}
+
+//----------------------------------------
+// Start the sweep running.  Call sweep_prepare() first.
+// Returns 'true' if the sweep was started.
+//----------------------------------------
+
+bool sweep_start(void)
+{
+  if (sweep_active || sweep_len == 0)
+    return false;
+
+  if (sweep_dwell < SWEEP_MIN_DWELL)
+    sweep_dwell = SWEEP_MIN_DWELL;
+
+  sweep_index = 0;
+  sweep_count = 0;
+  sweep_timer.priority(0);
+  sweep_active = sweep_timer.begin(sweep_isr, (unsigned int) sweep_dwell);
+  DEBUG("sweep_start: dwell=%ldus, started=%s\n",
+        sweep_dwell, (sweep_active) ? "true" : "false");
+  return sweep_active;
+}
+
+//----------------------------------------
+// Stop a running sweep.  The DDS is left at the last step loaded.
+//----------------------------------------
+
+void sweep_stop(void)
+{
+  if (sweep_active)
+  {
+    sweep_timer.end();
+    sweep_active = false;
+    DEBUG("sweep_stop: stopped after %ld passes\n", sweep_count);
+  }
+}
+
+//----------------------------------------
+// Returns 'true' if a sweep is running.
+//----------------------------------------
+
+bool sweep_running(void)
+{
+  return sweep_active;
+}
+
+//----------------------------------------
+// Returns the number of complete passes of the current sweep.
+//----------------------------------------
+
+unsigned long sweep_passes(void)
+{
+  return sweep_count;
+}
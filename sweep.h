@@ -0,0 +1,33 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+////////////////////////////////////////////////////////////////////////////////
+// A frequency sweep generator for PixelVFO.
+//
+// The frequencies for a sweep are converted to DDS tuning words once, before
+// the sweep starts.  A hardware interval timer then loads one word from the
+// table on each tick, so the step rate doesn't depend on what loop() is doing.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+#include "PixelVFO.h"
+
+// maximum number of steps in one sweep
+#define SWEEP_MAX_STEPS     1024
+
+// shortest dwell time we allow (50000 steps/second)
+#define SWEEP_MIN_DWELL     20
+
+// the sweep parameters
+extern Frequency sweep_start_freq;      // first frequency of sweep (Hz)
+extern Frequency sweep_stop_freq;       // last frequency of sweep (Hz)
+extern Frequency sweep_step_freq;       // frequency step (Hz)
+extern unsigned long sweep_dwell;       // time at each step (microseconds)
+
+int sweep_prepare(void);
+bool sweep_start(void);
+void sweep_stop(void);
+bool sweep_running(void);
+unsigned long sweep_passes(void);
+
+#endif
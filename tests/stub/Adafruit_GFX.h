@@ -0,0 +1,41 @@
+#pragma once
+// Host stand-in for <Adafruit_GFX.h>, for the host tests.
+//
+// The drawing code follows the Adafruit library, so the same calls reach
+// the same virtual primitives, see gfx.cpp.  The fonts are stand-ins.
+#include <Arduino.h>
+typedef struct { uint16_t bitmapOffset; uint8_t width, height, xAdvance; int8_t xOffset, yOffset; } GFXglyph;
+typedef struct { uint8_t *bitmap; GFXglyph *glyph; uint16_t first, last; uint8_t yAdvance; } GFXfont;
+class Adafruit_GFX : public Print { public:
+  Adafruit_GFX(int16_t w, int16_t h);
+  virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+  virtual void startWrite(void); virtual void writePixel(int16_t x, int16_t y, uint16_t color);
+  virtual void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  virtual void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+  virtual void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  virtual void writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+  virtual void endWrite(void);
+  virtual void setRotation(uint8_t r); virtual void invertDisplay(bool i);
+  virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+  virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  virtual void fillScreen(uint16_t color);
+  virtual void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+  virtual void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  void drawRoundRect(int16_t x0, int16_t y0, int16_t w, int16_t h, int16_t radius, uint16_t color);
+  void fillRoundRect(int16_t x0, int16_t y0, int16_t w, int16_t h, int16_t radius, uint16_t color);
+  void fillTriangle(int16_t, int16_t, int16_t, int16_t, int16_t, int16_t, uint16_t);
+  void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size);
+  void setCursor(int16_t, int16_t); void setTextColor(uint16_t); void setTextColor(uint16_t, uint16_t);
+  void setTextSize(uint8_t); void setTextWrap(bool); void setFont(const GFXfont *f = NULL);
+  void getTextBounds(const char *s, int16_t x, int16_t y, int16_t *x1, int16_t *y1, uint16_t *w, uint16_t *h);
+  virtual size_t write(uint8_t); int16_t width() const; int16_t height() const; uint8_t getRotation() const;
+  int16_t getCursorX() const; int16_t getCursorY() const;
+  using Print::write;
+protected:
+  void drawCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corners, uint16_t color);
+  void fillCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corners, int16_t delta, uint16_t color);
+  void charBounds(unsigned char c, int16_t *x, int16_t *y, int16_t *minx, int16_t *miny, int16_t *maxx, int16_t *maxy);
+  int16_t WIDTH, HEIGHT; int16_t _width, _height; int16_t cursor_x, cursor_y;
+  uint16_t textcolor, textbgcolor; uint8_t textsize, rotation; bool wrap; const GFXfont *gfxFont;
+};
@@ -0,0 +1,26 @@
+#pragma once
+// Host stand-in for <Adafruit_ILI9341.h>, for the host tests, see gfx.cpp.
+#include <Adafruit_SPITFT.h>
+#define ILI9341_DISPOFF 0x28
+#define ILI9341_DISPON 0x29
+#define ILI9341_BLACK 0x0000
+#define ILI9341_WHITE 0xFFFF
+#define ILI9341_DARKGREY 0x7BEF
+#define ILI9341_LIGHTGREY 0xC618
+#define ILI9341_RED 0xF800
+#define ILI9341_GREEN 0x07E0
+#define ILI9341_BLUE 0x001F
+#define ILI9341_YELLOW 0xFFE0
+#define ILI9341_CYAN 0x07FF
+#define ILI9341_MAGENTA 0xF81F
+#define ILI9341_ORANGE 0xFD20
+#define ILI9341_NAVY 0x000F
+#define ILI9341_DARKGREEN 0x03E0
+class Adafruit_ILI9341 : public Adafruit_SPITFT { public:
+  Adafruit_ILI9341(int8_t cs, int8_t dc, int8_t rst = -1);
+  void begin(uint32_t freq = 0); void init(uint16_t w, uint16_t h);
+  void setRotation(uint8_t m) override; void invertDisplay(bool i) override;
+  void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) override;
+  void scrollTo(uint16_t y); void setScrollMargins(uint16_t top, uint16_t bottom);
+  uint8_t readcommand8(uint8_t reg, uint8_t index = 0);
+};
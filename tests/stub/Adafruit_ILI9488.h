@@ -0,0 +1,22 @@
+#pragma once
+// Host stand-in for <Adafruit_ILI9488.h>, declarations only, for the host tests.
+#include <Adafruit_SPITFT.h>
+#define ILI9488_BLACK 0x0000
+#define ILI9488_WHITE 0xFFFF
+#define ILI9488_RED 0xF800
+#define ILI9488_GREEN 0x07E0
+#define ILI9488_BLUE 0x001F
+#define ILI9488_YELLOW 0xFFE0
+#define ILI9488_CYAN 0x07FF
+#define ILI9488_MAGENTA 0xF81F
+#define ILI9488_ORANGE 0xFD20
+#define ILI9488_NAVY 0x000F
+#define ILI9488_DARKGREEN 0x03E0
+class Adafruit_ILI9488 : public Adafruit_SPITFT { public:
+  Adafruit_ILI9488(int8_t cs, int8_t dc, int8_t rst = -1);
+  void begin(uint32_t freq = 0); void init(uint16_t w, uint16_t h);
+  void setRotation(uint8_t m) override; void invertDisplay(bool i) override;
+  void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) override;
+  void scrollTo(uint16_t y); void setScrollMargins(uint16_t top, uint16_t bottom);
+  uint8_t readcommand8(uint8_t reg, uint8_t index = 0);
+};
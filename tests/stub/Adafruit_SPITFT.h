@@ -0,0 +1,32 @@
+#pragma once
+// Host stand-in for <Adafruit_SPITFT.h>, for the host tests.
+//
+// The panel is a framebuffer in screen coordinates after rotation, see
+// gfx.cpp.  Pixels sent after setAddrWindow() fill the window as on the
+// panel.  The commands and bus routines do nothing.
+#include <Adafruit_GFX.h>
+class Adafruit_SPITFT : public Adafruit_GFX { public:
+  Adafruit_SPITFT(uint16_t w, uint16_t h, int8_t cs, int8_t dc, int8_t rst);
+  ~Adafruit_SPITFT();
+  void startWrite(void) override; void endWrite(void) override;
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void writePixel(int16_t x, int16_t y, uint16_t color) override;
+  void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+  void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  virtual void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) = 0;
+  void writeColor(uint16_t color, uint32_t len);
+  void writePixels(uint16_t *colors, uint32_t len, bool block = true, bool bigEndian = false);
+  void sendCommand(uint8_t commandByte, uint8_t *dataBytes = NULL, uint8_t numDataBytes = 0);
+  void writeCommand(uint8_t cmd); void spiWrite(uint8_t b); void SPI_WRITE16(uint16_t w); void SPI_WRITE32(uint32_t l);
+  void SPI_CS_LOW(); void SPI_CS_HIGH(); void SPI_DC_HIGH(); void SPI_DC_LOW();
+  uint16_t color565(uint8_t r, uint8_t g, uint8_t b); void setSPISpeed(uint32_t freq);
+  uint16_t pixel(int16_t x, int16_t y) const;   // host only, read the framebuffer
+protected:
+  void window(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+  void fillPreclipped(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  uint16_t *framebuffer; int16_t win_x, win_y, win_w, win_h; int32_t win_next;
+};
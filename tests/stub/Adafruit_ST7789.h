@@ -0,0 +1,22 @@
+#pragma once
+// Host stand-in for <Adafruit_ST7789.h>, declarations only, for the host tests.
+#include <Adafruit_SPITFT.h>
+#define ST7789_BLACK 0x0000
+#define ST7789_WHITE 0xFFFF
+#define ST7789_RED 0xF800
+#define ST7789_GREEN 0x07E0
+#define ST7789_BLUE 0x001F
+#define ST7789_YELLOW 0xFFE0
+#define ST7789_CYAN 0x07FF
+#define ST7789_MAGENTA 0xF81F
+#define ST7789_ORANGE 0xFD20
+#define ST7789_NAVY 0x000F
+#define ST7789_DARKGREEN 0x03E0
+class Adafruit_ST7789 : public Adafruit_SPITFT { public:
+  Adafruit_ST7789(int8_t cs, int8_t dc, int8_t rst = -1);
+  void begin(uint32_t freq = 0); void init(uint16_t w, uint16_t h);
+  void setRotation(uint8_t m) override; void invertDisplay(bool i) override;
+  void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) override;
+  void scrollTo(uint16_t y); void setScrollMargins(uint16_t top, uint16_t bottom);
+  uint8_t readcommand8(uint8_t reg, uint8_t index = 0);
+};
@@ -0,0 +1,66 @@
+#pragma once
+// Host stand-in for <Arduino.h>, for the host tests.
+//
+// Time is simulated, see host.h.  Print, Serial, the clock and IntervalTimer
+// are implemented in host.cpp, the rest is declarations only.
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <stdarg.h>
+#define F(s) (s)
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define CHANGE 4
+#define RISING 3
+#define FALLING 2
+#define A0 14
+#define A1 15
+#define __disable_irq() do{}while(0)
+#define __enable_irq() do{}while(0)
+#define F_CPU 72000000
+#define F_BUS 48000000
+typedef uint8_t byte;
+class Print { public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t) = 0; virtual size_t write(const uint8_t*, size_t);
+  size_t write(const char *s) { return write((const uint8_t *) s, strlen(s)); }
+  size_t print(const char*); size_t print(char); size_t print(int); size_t print(unsigned long);
+  size_t println(const char*); size_t println();
+  int printf(const char*, ...) __attribute__((format(printf,2,3)));
+  virtual int availableForWrite() { return 0; }
+  virtual void flush() {}
+};
+class Stream : public Print { public: virtual int available() = 0; virtual int read() = 0; virtual int peek() = 0; size_t readBytes(char*, size_t);};
+class usb_serial_class : public Stream { public:
+  void begin(long) {} operator bool() { return true; } int dtr() { return 1; }
+  int available() override; int read() override; int peek() override;
+  int availableForWrite() override; void flush() override;
+  size_t write(uint8_t) override; size_t write(const uint8_t*, size_t) override;
+  using Print::write;
+};
+extern usb_serial_class Serial;
+unsigned long millis(); unsigned long micros(); void delay(unsigned long); void delayMicroseconds(unsigned int);
+long map(long, long, long, long, long);
+void pinMode(uint8_t, uint8_t); void digitalWrite(uint8_t, uint8_t); int digitalRead(uint8_t);
+void digitalWriteFast(uint8_t, uint8_t); int digitalReadFast(uint8_t);
+int analogRead(uint8_t); void analogReadResolution(int); void analogWrite(uint8_t, int);
+void attachInterrupt(uint8_t, void (*)(void), int); void detachInterrupt(uint8_t);
+int digitalPinToInterrupt(int);
+void yield(void);
+class IntervalTimer { public:
+  IntervalTimer() : func(NULL), period(0), next(0) {} ~IntervalTimer() { end(); }
+  bool begin(void (*)(), unsigned int); bool begin(void (*f)(), float us) { return begin(f, (unsigned int) us); }
+  void end(); void priority(uint8_t) {} void update(unsigned int us) { period = us; }
+  void (*func)(); unsigned int period; uint32_t next;   // host state, see host.cpp
+};
+class elapsedMillis { unsigned long ms; public: elapsedMillis() : ms(millis()) {} operator unsigned long() const { return millis() - ms; } elapsedMillis& operator=(unsigned long v) { ms = millis() - v; return *this; } };
+class elapsedMicros { unsigned long us; public: elapsedMicros() : us(micros()) {} operator unsigned long() const { return micros() - us; } elapsedMicros& operator=(unsigned long v) { us = micros() - v; return *this; } };
+template<class T> T min(T a, T b) { return a<b?a:b; }
+template<class T> T max(T a, T b) { return a>b?a:b; }
+#include "kinetis.h"
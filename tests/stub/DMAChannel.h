@@ -0,0 +1,7 @@
+#pragma once
+// Host stand-in for <DMAChannel.h>, declarations only, for the host tests.
+#include <stdint.h>
+struct TCD_t { volatile const void *SADDR; int16_t SOFF; uint16_t ATTR; uint32_t NBYTES; int32_t SLAST; volatile void *DADDR; int16_t DOFF; uint16_t CITER; int32_t DLASTSGA; uint16_t CSR; uint16_t BITER; };
+class DMAChannel { public: TCD_t *TCD; uint8_t channel;
+ void source(volatile const uint32_t &); void destination(volatile uint32_t &); void transferSize(unsigned int); void transferCount(unsigned int);
+ void triggerAtHardwareEvent(uint8_t); void enable(); void disable(); void disableOnCompletion(); void interruptAtCompletion(); bool complete(); void clearComplete(); void attachInterrupt(void (*)(void)); void clearInterrupt(); void begin(bool force=false); void sourceBuffer(volatile const uint32_t*, unsigned int);};
@@ -0,0 +1,9 @@
+#pragma once
+// Host stand-in for <EEPROM.h>, for the host tests.  The EEPROM is an
+// array in board.cpp, erased (0xFF) at the start.
+#include <Arduino.h>
+#define HOST_EEPROM_SIZE 2048
+extern uint8_t host_eeprom[HOST_EEPROM_SIZE];
+class EEPROMClass { public: template<class T> T& get(int a, T& t){memcpy(&t, host_eeprom + a, sizeof(T)); return t;} template<class T> const T& put(int a, const T& t){memcpy(host_eeprom + a, &t, sizeof(T)); return t;} uint8_t read(int); void write(int, uint8_t); void update(int, uint8_t); uint16_t length(); };
+extern EEPROMClass EEPROM;
+inline void eeprom_write_dword(uint32_t *, uint32_t) {} inline uint32_t eeprom_read_dword(const uint32_t *) {return 0;}
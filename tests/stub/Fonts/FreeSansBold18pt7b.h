@@ -0,0 +1,4 @@
+#pragma once
+// Host stand-in for <Fonts/FreeSansBold18pt7b.h>, a stand-in font made in gfx.cpp.
+#include <Adafruit_GFX.h>
+extern const GFXfont FreeSansBold18pt7b;
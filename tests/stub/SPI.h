@@ -0,0 +1,11 @@
+#pragma once
+// Host stand-in for <SPI.h>, declarations only, for the host tests.
+#include <Arduino.h>
+#define MSBFIRST 1
+#define SPI_MODE0 0
+#define SPI_MODE1 1
+#define SPI_MODE2 2
+#define SPI_MODE3 3
+class SPISettings { public: SPISettings(); SPISettings(uint32_t, uint8_t, uint8_t); };
+class SPIClass { public: void begin(); void beginTransaction(SPISettings); void endTransaction(); uint8_t transfer(uint8_t); uint16_t transfer16(uint16_t); void usingInterrupt(uint8_t);};
+extern SPIClass SPI;
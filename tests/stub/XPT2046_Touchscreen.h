@@ -0,0 +1,5 @@
+#pragma once
+// Host stand-in for <XPT2046_Touchscreen.h>, declarations only, for the host tests.
+#include <Arduino.h>
+class TS_Point { public: int16_t x, y, z; };
+class XPT2046_Touchscreen { public: XPT2046_Touchscreen(uint8_t cs, uint8_t irq=255); bool begin(); TS_Point getPoint(); bool tirqTouched(); bool touched(); void setRotation(uint8_t);};
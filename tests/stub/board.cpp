@@ -0,0 +1,96 @@
+// Host board for the host tests: the pins, SPI, EEPROM, touchscreen and
+// registers the whole sketch links against.
+//
+// The pins read idle, high with the pullups on, and the touchscreen is
+// never touched.  The EEPROM is erased, so the sketch starts from its
+// defaults.
+#include <Arduino.h>
+#include <SPI.h>
+#include <EEPROM.h>
+#include <XPT2046_Touchscreen.h>
+
+//----------------------------------------
+// Pins.
+//----------------------------------------
+
+void pinMode(uint8_t, uint8_t) {}
+void digitalWrite(uint8_t, uint8_t) {}
+int digitalRead(uint8_t) { return HIGH; }
+void digitalWriteFast(uint8_t, uint8_t) {}
+int digitalReadFast(uint8_t) { return HIGH; }
+int analogRead(uint8_t) { return 0; }
+void analogReadResolution(int) {}
+void analogWrite(uint8_t, int) {}
+void attachInterrupt(uint8_t, void (*)(void), int) {}
+void detachInterrupt(uint8_t) {}
+int digitalPinToInterrupt(int pin) { return pin; }
+
+long map(long x, long in_min, long in_max, long out_min, long out_max)
+{
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+//----------------------------------------
+// SPI, nothing on the bus.
+//----------------------------------------
+
+SPIClass SPI;
+
+SPISettings::SPISettings() {}
+SPISettings::SPISettings(uint32_t, uint8_t, uint8_t) {}
+void SPIClass::begin() {}
+void SPIClass::beginTransaction(SPISettings) {}
+void SPIClass::endTransaction() {}
+uint8_t SPIClass::transfer(uint8_t) { return 0; }
+uint16_t SPIClass::transfer16(uint16_t) { return 0; }
+void SPIClass::usingInterrupt(uint8_t) {}
+
+//----------------------------------------
+// EEPROM.
+//----------------------------------------
+
+uint8_t host_eeprom[HOST_EEPROM_SIZE];
+EEPROMClass EEPROM;
+
+__attribute__((constructor)) static void host_eeprom_erase(void)
+{
+  memset(host_eeprom, 0xFF, sizeof(host_eeprom));
+}
+
+uint8_t EEPROMClass::read(int addr) { return host_eeprom[addr]; }
+void EEPROMClass::write(int addr, uint8_t value) { host_eeprom[addr] = value; }
+void EEPROMClass::update(int addr, uint8_t value) { host_eeprom[addr] = value; }
+uint16_t EEPROMClass::length() { return HOST_EEPROM_SIZE; }
+
+//----------------------------------------
+// Touchscreen.
+//----------------------------------------
+
+XPT2046_Touchscreen::XPT2046_Touchscreen(uint8_t, uint8_t) {}
+bool XPT2046_Touchscreen::begin() { return true; }
+TS_Point XPT2046_Touchscreen::getPoint() { return TS_Point{0, 0, 0}; }
+bool XPT2046_Touchscreen::tirqTouched() { return false; }
+bool XPT2046_Touchscreen::touched() { return false; }
+void XPT2046_Touchscreen::setRotation(uint8_t) {}
+
+//----------------------------------------
+// Registers, plain variables.
+//----------------------------------------
+
+volatile uint32_t ARM_DWT_CYCCNT, ARM_DWT_CTRL, ARM_DEMCR, SIM_SCGC3, SIM_SCGC6, SIM_SOPT4, PORTB_PCR16, PORTB_PCR18, PORTB_PCR19;
+volatile uint32_t FTM2_SC, FTM2_CNT, FTM2_MOD, FTM2_C0SC, FTM2_C1SC, FTM2_C0V, FTM2_C1V, FTM2_CNTIN, FTM2_MODE, FTM2_FILTER;
+volatile uint32_t SPI0_PUSHR, SPI0_SR, SPI0_RSER, SPI0_MCR, SPI0_CTAR0, SPI0_CTAR1;
+volatile uint32_t CORE_PIN0_CONFIG, CORE_PIN25_CONFIG;
+
+//----------------------------------------
+// Memory layout, see memory.cpp.  The top of the heap is put just below
+// the caller's stack frame, so mem_init() finds less than
+// MEM_HEAP_RESERVE free and paints nothing.
+//----------------------------------------
+
+char _sdata, _ebss, _estack;
+
+extern "C" char *sbrk(int)
+{
+  return (char *) __builtin_frame_address(0);
+}
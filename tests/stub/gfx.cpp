@@ -0,0 +1,803 @@
+// Host display for the host tests: Adafruit_GFX, Adafruit_SPITFT and
+// Adafruit_ILI9341 drawing into a framebuffer.
+//
+// The shapes, text and clipping follow the Adafruit library, calling the
+// same virtual primitives in the same order, so a driver that hooks them
+// (MirrorTFT) sees what it would see on the Teensy.  The fonts are not the
+// Adafruit ones.  Every font is the classic 5x7 font below, scaled to
+// about the size of the font it stands in for.
+#include <Adafruit_ILI9341.h>
+#include <Fonts/FreeSans9pt7b.h>
+#include <Fonts/FreeSansBold9pt7b.h>
+#include <Fonts/FreeSansBold12pt7b.h>
+#include <Fonts/FreeSansBold18pt7b.h>
+#include <Fonts/FreeSansBold24pt7b.h>
+
+#define ILI9341_TFTWIDTH    240
+#define ILI9341_TFTHEIGHT   320
+
+template <class T> static void swap_values(T &a, T &b) { T t = a; a = b; b = t; }
+
+//----------------------------------------
+// The classic font, ' ' to '~', five columns each, the top row in bit 0.
+//----------------------------------------
+
+static const uint8_t host_glcd[][5] =
+{
+  {0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x5F, 0x00, 0x00}, {0x00, 0x07, 0x00, 0x07, 0x00},
+  {0x14, 0x7F, 0x14, 0x7F, 0x14}, {0x24, 0x2A, 0x7F, 0x2A, 0x12}, {0x23, 0x13, 0x08, 0x64, 0x62},
+  {0x36, 0x49, 0x55, 0x22, 0x50}, {0x00, 0x05, 0x03, 0x00, 0x00}, {0x00, 0x1C, 0x22, 0x41, 0x00},
+  {0x00, 0x41, 0x22, 0x1C, 0x00}, {0x08, 0x2A, 0x1C, 0x2A, 0x08}, {0x08, 0x08, 0x3E, 0x08, 0x08},
+  {0x00, 0x50, 0x30, 0x00, 0x00}, {0x08, 0x08, 0x08, 0x08, 0x08}, {0x00, 0x60, 0x60, 0x00, 0x00},
+  {0x20, 0x10, 0x08, 0x04, 0x02}, {0x3E, 0x51, 0x49, 0x45, 0x3E}, {0x00, 0x42, 0x7F, 0x40, 0x00},
+  {0x42, 0x61, 0x51, 0x49, 0x46}, {0x21, 0x41, 0x45, 0x4B, 0x31}, {0x18, 0x14, 0x12, 0x7F, 0x10},
+  {0x27, 0x45, 0x45, 0x45, 0x39}, {0x3C, 0x4A, 0x49, 0x49, 0x30}, {0x01, 0x71, 0x09, 0x05, 0x03},
+  {0x36, 0x49, 0x49, 0x49, 0x36}, {0x06, 0x49, 0x49, 0x29, 0x1E}, {0x00, 0x36, 0x36, 0x00, 0x00},
+  {0x00, 0x56, 0x36, 0x00, 0x00}, {0x08, 0x14, 0x22, 0x41, 0x00}, {0x14, 0x14, 0x14, 0x14, 0x14},
+  {0x00, 0x41, 0x22, 0x14, 0x08}, {0x02, 0x01, 0x51, 0x09, 0x06}, {0x32, 0x49, 0x79, 0x41, 0x3E},
+  {0x7E, 0x11, 0x11, 0x11, 0x7E}, {0x7F, 0x49, 0x49, 0x49, 0x36}, {0x3E, 0x41, 0x41, 0x41, 0x22},
+  {0x7F, 0x41, 0x41, 0x22, 0x1C}, {0x7F, 0x49, 0x49, 0x49, 0x41}, {0x7F, 0x09, 0x09, 0x01, 0x01},
+  {0x3E, 0x41, 0x41, 0x51, 0x32}, {0x7F, 0x08, 0x08, 0x08, 0x7F}, {0x00, 0x41, 0x7F, 0x41, 0x00},
+  {0x20, 0x40, 0x41, 0x3F, 0x01}, {0x7F, 0x08, 0x14, 0x22, 0x41}, {0x7F, 0x40, 0x40, 0x40, 0x40},
+  {0x7F, 0x02, 0x04, 0x02, 0x7F}, {0x7F, 0x04, 0x08, 0x10, 0x7F}, {0x3E, 0x41, 0x41, 0x41, 0x3E},
+  {0x7F, 0x09, 0x09, 0x09, 0x06}, {0x3E, 0x41, 0x51, 0x21, 0x5E}, {0x7F, 0x09, 0x19, 0x29, 0x46},
+  {0x46, 0x49, 0x49, 0x49, 0x31}, {0x01, 0x01, 0x7F, 0x01, 0x01}, {0x3F, 0x40, 0x40, 0x40, 0x3F},
+  {0x1F, 0x20, 0x40, 0x20, 0x1F}, {0x7F, 0x20, 0x18, 0x20, 0x7F}, {0x63, 0x14, 0x08, 0x14, 0x63},
+  {0x03, 0x04, 0x78, 0x04, 0x03}, {0x61, 0x51, 0x49, 0x45, 0x43}, {0x00, 0x7F, 0x41, 0x41, 0x00},
+  {0x02, 0x04, 0x08, 0x10, 0x20}, {0x00, 0x41, 0x41, 0x7F, 0x00}, {0x04, 0x02, 0x01, 0x02, 0x04},
+  {0x40, 0x40, 0x40, 0x40, 0x40}, {0x00, 0x01, 0x02, 0x04, 0x00}, {0x20, 0x54, 0x54, 0x54, 0x78},
+  {0x7F, 0x48, 0x44, 0x44, 0x38}, {0x38, 0x44, 0x44, 0x44, 0x20}, {0x38, 0x44, 0x44, 0x48, 0x7F},
+  {0x38, 0x54, 0x54, 0x54, 0x18}, {0x08, 0x7E, 0x09, 0x01, 0x02}, {0x08, 0x14, 0x54, 0x54, 0x3C},
+  {0x7F, 0x08, 0x04, 0x04, 0x78}, {0x00, 0x44, 0x7D, 0x40, 0x00}, {0x20, 0x40, 0x44, 0x3D, 0x00},
+  {0x00, 0x7F, 0x10, 0x28, 0x44}, {0x00, 0x41, 0x7F, 0x40, 0x00}, {0x7C, 0x04, 0x18, 0x04, 0x78},
+  {0x7C, 0x08, 0x04, 0x04, 0x78}, {0x38, 0x44, 0x44, 0x44, 0x38}, {0x7C, 0x14, 0x14, 0x14, 0x08},
+  {0x08, 0x14, 0x14, 0x18, 0x7C}, {0x7C, 0x08, 0x04, 0x04, 0x08}, {0x48, 0x54, 0x54, 0x54, 0x20},
+  {0x04, 0x3F, 0x44, 0x40, 0x20}, {0x3C, 0x40, 0x40, 0x20, 0x7C}, {0x1C, 0x20, 0x40, 0x20, 0x1C},
+  {0x3C, 0x40, 0x30, 0x40, 0x3C}, {0x44, 0x28, 0x10, 0x28, 0x44}, {0x0C, 0x50, 0x50, 0x50, 0x3C},
+  {0x44, 0x64, 0x54, 0x4C, 0x44}, {0x00, 0x08, 0x36, 0x41, 0x00}, {0x00, 0x00, 0x7F, 0x00, 0x00},
+  {0x00, 0x41, 0x36, 0x08, 0x00}, {0x08, 0x04, 0x08, 0x10, 0x08},
+};
+
+#define GLCD_FIRST  ' '
+#define GLCD_LAST   '~'
+
+// the column bits of a classic font character, blank outside the font
+static uint8_t glcd_column(unsigned char c, int col)
+{
+  if ((c < GLCD_FIRST) || (c > GLCD_LAST) || (col > 4))
+    return 0;
+  return host_glcd[c - GLCD_FIRST][col];
+}
+
+//----------------------------------------
+// Make a stand-in GFX font, the classic font scaled to 'w' x 'h' pixels.
+//     w        glyph width
+//     h        glyph height, all of it above the baseline
+//     advance  cursor movement for each character
+//     line     cursor movement for each line
+//----------------------------------------
+
+static GFXfont host_font(int w, int h, int advance, int line)
+{
+  int count = GLCD_LAST - GLCD_FIRST + 1;
+  int bytes = (w * h + 7) / 8;
+  uint8_t *bitmap = new uint8_t[count * bytes]();
+  GFXglyph *glyph = new GFXglyph[count];
+
+  for (int i = 0; i < count; ++i)
+  {
+    int bit = 0;
+
+    glyph[i] = {(uint16_t) (i * bytes), (uint8_t) w, (uint8_t) h, (uint8_t) advance,
+                (int8_t) 1, (int8_t) -h};
+    for (int y = 0; y < h; ++y)
+      for (int x = 0; x < w; ++x, ++bit)
+        if (glcd_column(GLCD_FIRST + i, x * 5 / w) & (1 << (y * 7 / h)))
+          bitmap[i * bytes + bit / 8] |= 0x80 >> (bit % 8);
+  }
+
+  return {bitmap, glyph, GLCD_FIRST, GLCD_LAST, (uint8_t) line};
+}
+
+const GFXfont FreeSans9pt7b = host_font(7, 12, 10, 22);
+const GFXfont FreeSansBold9pt7b = host_font(8, 12, 10, 22);
+const GFXfont FreeSansBold12pt7b = host_font(11, 16, 13, 29);
+const GFXfont FreeSansBold18pt7b = host_font(16, 24, 19, 42);
+const GFXfont FreeSansBold24pt7b = host_font(23, 33, 27, 56);
+
+//----------------------------------------
+// Adafruit_GFX, the shapes and text, built on the virtual primitives.
+//----------------------------------------
+
+Adafruit_GFX::Adafruit_GFX(int16_t w, int16_t h)
+  : WIDTH(w), HEIGHT(h), _width(w), _height(h), cursor_x(0), cursor_y(0),
+    textcolor(0xFFFF), textbgcolor(0xFFFF), textsize(1), rotation(0), wrap(true), gfxFont(NULL)
+{
+}
+
+void Adafruit_GFX::startWrite(void) {}
+void Adafruit_GFX::endWrite(void) {}
+void Adafruit_GFX::writePixel(int16_t x, int16_t y, uint16_t color) { drawPixel(x, y, color); }
+void Adafruit_GFX::writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) { drawFastVLine(x, y, h, color); }
+void Adafruit_GFX::writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) { drawFastHLine(x, y, w, color); }
+void Adafruit_GFX::writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) { fillRect(x, y, w, h, color); }
+void Adafruit_GFX::invertDisplay(bool) {}
+
+void Adafruit_GFX::writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color)
+{
+  bool steep = abs(y1 - y0) > abs(x1 - x0);
+
+  if (steep)
+  {
+    swap_values(x0, y0);
+    swap_values(x1, y1);
+  }
+  if (x0 > x1)
+  {
+    swap_values(x0, x1);
+    swap_values(y0, y1);
+  }
+
+  int16_t dx = x1 - x0;
+  int16_t dy = abs(y1 - y0);
+  int16_t err = dx / 2;
+  int16_t ystep = (y0 < y1) ? 1 : -1;
+
+  for (; x0 <= x1; x0++)
+  {
+    if (steep)
+      writePixel(y0, x0, color);
+    else
+      writePixel(x0, y0, color);
+    err -= dy;
+    if (err < 0)
+    {
+      y0 += ystep;
+      err += dx;
+    }
+  }
+}
+
+void Adafruit_GFX::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+{
+  startWrite();
+  writeLine(x, y, x, y + h - 1, color);
+  endWrite();
+}
+
+void Adafruit_GFX::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+  startWrite();
+  writeLine(x, y, x + w - 1, y, color);
+  endWrite();
+}
+
+void Adafruit_GFX::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+  startWrite();
+  for (int16_t i = x; i < x + w; i++)
+    writeFastVLine(i, y, h, color);
+  endWrite();
+}
+
+void Adafruit_GFX::fillScreen(uint16_t color)
+{
+  fillRect(0, 0, _width, _height, color);
+}
+
+void Adafruit_GFX::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color)
+{
+  if (x0 == x1)
+  {
+    if (y0 > y1)
+      swap_values(y0, y1);
+    drawFastVLine(x0, y0, y1 - y0 + 1, color);
+  }
+  else if (y0 == y1)
+  {
+    if (x0 > x1)
+      swap_values(x0, x1);
+    drawFastHLine(x0, y0, x1 - x0 + 1, color);
+  }
+  else
+  {
+    startWrite();
+    writeLine(x0, y0, x1, y1, color);
+    endWrite();
+  }
+}
+
+void Adafruit_GFX::drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+  startWrite();
+  writeFastHLine(x, y, w, color);
+  writeFastHLine(x, y + h - 1, w, color);
+  writeFastVLine(x, y, h, color);
+  writeFastVLine(x + w - 1, y, h, color);
+  endWrite();
+}
+
+void Adafruit_GFX::drawCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corners, uint16_t color)
+{
+  int16_t f = 1 - r;
+  int16_t ddF_x = 1;
+  int16_t ddF_y = -2 * r;
+  int16_t x = 0;
+  int16_t y = r;
+
+  while (x < y)
+  {
+    if (f >= 0)
+    {
+      y--;
+      ddF_y += 2;
+      f += ddF_y;
+    }
+    x++;
+    ddF_x += 2;
+    f += ddF_x;
+    if (corners & 0x4)
+    {
+      writePixel(x0 + x, y0 + y, color);
+      writePixel(x0 + y, y0 + x, color);
+    }
+    if (corners & 0x2)
+    {
+      writePixel(x0 + x, y0 - y, color);
+      writePixel(x0 + y, y0 - x, color);
+    }
+    if (corners & 0x8)
+    {
+      writePixel(x0 - y, y0 + x, color);
+      writePixel(x0 - x, y0 + y, color);
+    }
+    if (corners & 0x1)
+    {
+      writePixel(x0 - y, y0 - x, color);
+      writePixel(x0 - x, y0 - y, color);
+    }
+  }
+}
+
+void Adafruit_GFX::fillCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corners, int16_t delta,
+                                    uint16_t color)
+{
+  int16_t f = 1 - r;
+  int16_t ddF_x = 1;
+  int16_t ddF_y = -2 * r;
+  int16_t x = 0;
+  int16_t y = r;
+  int16_t px = x;
+  int16_t py = y;
+
+  delta++;
+  while (x < y)
+  {
+    if (f >= 0)
+    {
+      y--;
+      ddF_y += 2;
+      f += ddF_y;
+    }
+    x++;
+    ddF_x += 2;
+    f += ddF_x;
+    if (x < (y + 1))
+    {
+      if (corners & 1)
+        writeFastVLine(x0 + x, y0 - y, 2 * y + delta, color);
+      if (corners & 2)
+        writeFastVLine(x0 - x, y0 - y, 2 * y + delta, color);
+    }
+    if (y != py)
+    {
+      if (corners & 1)
+        writeFastVLine(x0 + py, y0 - px, 2 * px + delta, color);
+      if (corners & 2)
+        writeFastVLine(x0 - py, y0 - px, 2 * px + delta, color);
+      py = y;
+    }
+    px = x;
+  }
+}
+
+void Adafruit_GFX::drawRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color)
+{
+  int16_t max_radius = ((w < h) ? w : h) / 2;
+
+  if (r > max_radius)
+    r = max_radius;
+  startWrite();
+  writeFastHLine(x + r, y, w - 2 * r, color);
+  writeFastHLine(x + r, y + h - 1, w - 2 * r, color);
+  writeFastVLine(x, y + r, h - 2 * r, color);
+  writeFastVLine(x + w - 1, y + r, h - 2 * r, color);
+  drawCircleHelper(x + r, y + r, r, 1, color);
+  drawCircleHelper(x + w - r - 1, y + r, r, 2, color);
+  drawCircleHelper(x + w - r - 1, y + h - r - 1, r, 4, color);
+  drawCircleHelper(x + r, y + h - r - 1, r, 8, color);
+  endWrite();
+}
+
+void Adafruit_GFX::fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color)
+{
+  int16_t max_radius = ((w < h) ? w : h) / 2;
+
+  if (r > max_radius)
+    r = max_radius;
+  startWrite();
+  writeFillRect(x + r, y, w - 2 * r, h, color);
+  fillCircleHelper(x + w - r - 1, y + r, r, 1, h - 2 * r - 1, color);
+  fillCircleHelper(x + r, y + r, r, 2, h - 2 * r - 1, color);
+  endWrite();
+}
+
+void Adafruit_GFX::fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2,
+                                uint16_t color)
+{
+  int16_t a, b, y, last;
+
+  if (y0 > y1)
+  {
+    swap_values(y0, y1);
+    swap_values(x0, x1);
+  }
+  if (y1 > y2)
+  {
+    swap_values(y2, y1);
+    swap_values(x2, x1);
+  }
+  if (y0 > y1)
+  {
+    swap_values(y0, y1);
+    swap_values(x0, x1);
+  }
+
+  startWrite();
+  if (y0 == y2)
+  {
+    a = b = x0;
+    if (x1 < a)
+      a = x1;
+    else if (x1 > b)
+      b = x1;
+    if (x2 < a)
+      a = x2;
+    else if (x2 > b)
+      b = x2;
+    writeFastHLine(a, y0, b - a + 1, color);
+    endWrite();
+    return;
+  }
+
+  int16_t dx01 = x1 - x0, dy01 = y1 - y0, dx02 = x2 - x0, dy02 = y2 - y0, dx12 = x2 - x1, dy12 = y2 - y1;
+  int32_t sa = 0, sb = 0;
+
+  last = (y1 == y2) ? y1 : y1 - 1;
+  for (y = y0; y <= last; y++)
+  {
+    a = x0 + sa / dy01;
+    b = x0 + sb / dy02;
+    sa += dx01;
+    sb += dx02;
+    if (a > b)
+      swap_values(a, b);
+    writeFastHLine(a, y, b - a + 1, color);
+  }
+
+  sa = (int32_t) dx12 * (y - y1);
+  sb = (int32_t) dx02 * (y - y0);
+  for (; y <= y2; y++)
+  {
+    a = x1 + sa / dy12;
+    b = x0 + sb / dy02;
+    sa += dx12;
+    sb += dx02;
+    if (a > b)
+      swap_values(a, b);
+    writeFastHLine(a, y, b - a + 1, color);
+  }
+  endWrite();
+}
+
+void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size)
+{
+  if (!gfxFont)
+  {
+    if ((x >= _width) || (y >= _height) || ((x + 6 * size - 1) < 0) || ((y + 8 * size - 1) < 0))
+      return;
+
+    startWrite();
+    for (int8_t i = 0; i < 5; i++)
+    {
+      uint8_t line = glcd_column(c, i);
+
+      for (int8_t j = 0; j < 8; j++, line >>= 1)
+      {
+        if (line & 1)
+        {
+          if (size == 1)
+            writePixel(x + i, y + j, color);
+          else
+            writeFillRect(x + i * size, y + j * size, size, size, color);
+        }
+        else if (bg != color)
+        {
+          if (size == 1)
+            writePixel(x + i, y + j, bg);
+          else
+            writeFillRect(x + i * size, y + j * size, size, size, bg);
+        }
+      }
+    }
+    if (bg != color)
+    {
+      if (size == 1)
+        writeFastVLine(x + 5, y, 8, bg);
+      else
+        writeFillRect(x + 5 * size, y, size, 8 * size, bg);
+    }
+    endWrite();
+    return;
+  }
+
+  // a GFX font draws only the set pixels, 'bg' is ignored
+  if ((c < gfxFont->first) || (c > gfxFont->last))
+    return;
+
+  GFXglyph *glyph = &gfxFont->glyph[c - gfxFont->first];
+  uint16_t bo = glyph->bitmapOffset;
+  uint8_t w = glyph->width;
+  uint8_t h = glyph->height;
+  int8_t xo = glyph->xOffset;
+  int8_t yo = glyph->yOffset;
+  uint8_t bits = 0;
+  uint8_t bit = 0;
+
+  startWrite();
+  for (uint8_t yy = 0; yy < h; yy++)
+  {
+    for (uint8_t xx = 0; xx < w; xx++)
+    {
+      if (!(bit++ & 7))
+        bits = gfxFont->bitmap[bo++];
+      if (bits & 0x80)
+      {
+        if (size == 1)
+          writePixel(x + xo + xx, y + yo + yy, color);
+        else
+          writeFillRect(x + (xo + xx) * size, y + (yo + yy) * size, size, size, color);
+      }
+      bits <<= 1;
+    }
+  }
+  endWrite();
+}
+
+size_t Adafruit_GFX::write(uint8_t c)
+{
+  if (!gfxFont)
+  {
+    if (c == '\n')
+    {
+      cursor_x = 0;
+      cursor_y += textsize * 8;
+    }
+    else if (c != '\r')
+    {
+      if (wrap && ((cursor_x + textsize * 6) > _width))
+      {
+        cursor_x = 0;
+        cursor_y += textsize * 8;
+      }
+      drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize);
+      cursor_x += textsize * 6;
+    }
+    return 1;
+  }
+
+  if (c == '\n')
+  {
+    cursor_x = 0;
+    cursor_y += textsize * gfxFont->yAdvance;
+  }
+  else if ((c != '\r') && (c >= gfxFont->first) && (c <= gfxFont->last))
+  {
+    GFXglyph *glyph = &gfxFont->glyph[c - gfxFont->first];
+
+    if ((glyph->width > 0) && (glyph->height > 0))
+    {
+      if (wrap && ((cursor_x + textsize * (glyph->xOffset + glyph->width)) > _width))
+      {
+        cursor_x = 0;
+        cursor_y += textsize * gfxFont->yAdvance;
+      }
+      drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize);
+    }
+    cursor_x += glyph->xAdvance * textsize;
+  }
+  return 1;
+}
+
+void Adafruit_GFX::charBounds(unsigned char c, int16_t *x, int16_t *y, int16_t *minx, int16_t *miny,
+                              int16_t *maxx, int16_t *maxy)
+{
+  if (!gfxFont)
+  {
+    if (c == '\n')
+    {
+      *x = 0;
+      *y += textsize * 8;
+    }
+    else if (c != '\r')
+    {
+      if (wrap && ((*x + textsize * 6) > _width))
+      {
+        *x = 0;
+        *y += textsize * 8;
+      }
+      int16_t x2 = *x + textsize * 6 - 1;
+      int16_t y2 = *y + textsize * 8 - 1;
+
+      if (x2 > *maxx) *maxx = x2;
+      if (y2 > *maxy) *maxy = y2;
+      if (*x < *minx) *minx = *x;
+      if (*y < *miny) *miny = *y;
+      *x += textsize * 6;
+    }
+    return;
+  }
+
+  if (c == '\n')
+  {
+    *x = 0;
+    *y += textsize * gfxFont->yAdvance;
+  }
+  else if ((c != '\r') && (c >= gfxFont->first) && (c <= gfxFont->last))
+  {
+    GFXglyph *glyph = &gfxFont->glyph[c - gfxFont->first];
+
+    if (wrap && ((*x + (glyph->xOffset + glyph->width) * textsize) > _width))
+    {
+      *x = 0;
+      *y += textsize * gfxFont->yAdvance;
+    }
+    int16_t x1 = *x + glyph->xOffset * textsize;
+    int16_t y1 = *y + glyph->yOffset * textsize;
+    int16_t x2 = x1 + glyph->width * textsize - 1;
+    int16_t y2 = y1 + glyph->height * textsize - 1;
+
+    if (x1 < *minx) *minx = x1;
+    if (y1 < *miny) *miny = y1;
+    if (x2 > *maxx) *maxx = x2;
+    if (y2 > *maxy) *maxy = y2;
+    *x += glyph->xAdvance * textsize;
+  }
+}
+
+void Adafruit_GFX::getTextBounds(const char *s, int16_t x, int16_t y, int16_t *x1, int16_t *y1,
+                                 uint16_t *w, uint16_t *h)
+{
+  int16_t minx = 0x7FFF, miny = 0x7FFF, maxx = -1, maxy = -1;
+
+  *x1 = x;
+  *y1 = y;
+  *w = *h = 0;
+  while (unsigned char c = *s++)
+    charBounds(c, &x, &y, &minx, &miny, &maxx, &maxy);
+  if (maxx >= minx)
+  {
+    *x1 = minx;
+    *w = maxx - minx + 1;
+  }
+  if (maxy >= miny)
+  {
+    *y1 = miny;
+    *h = maxy - miny + 1;
+  }
+}
+
+void Adafruit_GFX::setRotation(uint8_t r)
+{
+  rotation = r & 3;
+  _width = (rotation & 1) ? HEIGHT : WIDTH;
+  _height = (rotation & 1) ? WIDTH : HEIGHT;
+}
+
+void Adafruit_GFX::setFont(const GFXfont *f)
+{
+  if (f && !gfxFont)
+    cursor_y += 6;      // the classic font's top is the cursor, a GFX font's baseline
+  else if (!f && gfxFont)
+    cursor_y -= 6;
+  gfxFont = f;
+}
+
+void Adafruit_GFX::setCursor(int16_t x, int16_t y) { cursor_x = x; cursor_y = y; }
+void Adafruit_GFX::setTextColor(uint16_t c) { textcolor = textbgcolor = c; }
+void Adafruit_GFX::setTextColor(uint16_t c, uint16_t bg) { textcolor = c; textbgcolor = bg; }
+void Adafruit_GFX::setTextSize(uint8_t s) { textsize = (s > 0) ? s : 1; }
+void Adafruit_GFX::setTextWrap(bool w) { wrap = w; }
+int16_t Adafruit_GFX::width() const { return _width; }
+int16_t Adafruit_GFX::height() const { return _height; }
+uint8_t Adafruit_GFX::getRotation() const { return rotation; }
+int16_t Adafruit_GFX::getCursorX() const { return cursor_x; }
+int16_t Adafruit_GFX::getCursorY() const { return cursor_y; }
+
+//----------------------------------------
+// Adafruit_SPITFT, the framebuffer and the clipped primitives.
+//----------------------------------------
+
+Adafruit_SPITFT::Adafruit_SPITFT(uint16_t w, uint16_t h, int8_t, int8_t, int8_t)
+  : Adafruit_GFX(w, h), framebuffer(new uint16_t[w * h]()), win_x(0), win_y(0), win_w(0), win_h(0), win_next(0)
+{
+}
+
+Adafruit_SPITFT::~Adafruit_SPITFT()
+{
+  delete [] framebuffer;
+}
+
+void Adafruit_SPITFT::startWrite(void) {}
+void Adafruit_SPITFT::endWrite(void) {}
+
+// the window pixels sent next go to, as setAddrWindow() sets on the panel
+void Adafruit_SPITFT::window(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+  win_x = x;
+  win_y = y;
+  win_w = w;
+  win_h = h;
+  win_next = 0;
+}
+
+void Adafruit_SPITFT::SPI_WRITE16(uint16_t color)
+{
+  if (win_next >= (int32_t) win_w * win_h)
+    return;
+
+  int16_t x = win_x + win_next % win_w;
+  int16_t y = win_y + win_next / win_w;
+
+  if ((x < _width) && (y < _height))
+    framebuffer[y * _width + x] = color;
+  ++win_next;
+}
+
+void Adafruit_SPITFT::writeColor(uint16_t color, uint32_t len)
+{
+  while (len--)
+    SPI_WRITE16(color);
+}
+
+void Adafruit_SPITFT::writePixels(uint16_t *colors, uint32_t len, bool, bool)
+{
+  while (len--)
+    SPI_WRITE16(*colors++);
+}
+
+void Adafruit_SPITFT::fillPreclipped(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+  setAddrWindow(x, y, w, h);
+  writeColor(color, (uint32_t) w * h);
+}
+
+void Adafruit_SPITFT::writePixel(int16_t x, int16_t y, uint16_t color)
+{
+  if ((x >= 0) && (x < _width) && (y >= 0) && (y < _height))
+  {
+    setAddrWindow(x, y, 1, 1);
+    SPI_WRITE16(color);
+  }
+}
+
+void Adafruit_SPITFT::drawPixel(int16_t x, int16_t y, uint16_t color)
+{
+  if ((x >= 0) && (x < _width) && (y >= 0) && (y < _height))
+  {
+    startWrite();
+    setAddrWindow(x, y, 1, 1);
+    SPI_WRITE16(color);
+    endWrite();
+  }
+}
+
+void Adafruit_SPITFT::writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+  if (w < 0)
+  {
+    x += w + 1;
+    w = -w;
+  }
+  if (h < 0)
+  {
+    y += h + 1;
+    h = -h;
+  }
+  if ((w == 0) || (h == 0) || (x >= _width) || (y >= _height))
+    return;
+
+  int16_t x2 = x + w - 1;
+  int16_t y2 = y + h - 1;
+
+  if ((x2 < 0) || (y2 < 0))
+    return;
+  if (x < 0)
+    x = 0;
+  if (y < 0)
+    y = 0;
+  if (x2 >= _width)
+    x2 = _width - 1;
+  if (y2 >= _height)
+    y2 = _height - 1;
+  fillPreclipped(x, y, x2 - x + 1, y2 - y + 1, color);
+}
+
+void Adafruit_SPITFT::writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+{
+  writeFillRect(x, y, 1, h, color);
+}
+
+void Adafruit_SPITFT::writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+  writeFillRect(x, y, w, 1, color);
+}
+
+void Adafruit_SPITFT::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+{
+  startWrite();
+  writeFastVLine(x, y, h, color);
+  endWrite();
+}
+
+void Adafruit_SPITFT::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+  startWrite();
+  writeFastHLine(x, y, w, color);
+  endWrite();
+}
+
+void Adafruit_SPITFT::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+  startWrite();
+  writeFillRect(x, y, w, h, color);
+  endWrite();
+}
+
+uint16_t Adafruit_SPITFT::pixel(int16_t x, int16_t y) const
+{
+  return framebuffer[y * _width + x];
+}
+
+uint16_t Adafruit_SPITFT::color565(uint8_t r, uint8_t g, uint8_t b)
+{
+  return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+}
+
+void Adafruit_SPITFT::sendCommand(uint8_t, uint8_t *, uint8_t) {}
+void Adafruit_SPITFT::writeCommand(uint8_t) {}
+void Adafruit_SPITFT::spiWrite(uint8_t) {}
+void Adafruit_SPITFT::SPI_WRITE32(uint32_t) {}
+void Adafruit_SPITFT::SPI_CS_LOW() {}
+void Adafruit_SPITFT::SPI_CS_HIGH() {}
+void Adafruit_SPITFT::SPI_DC_HIGH() {}
+void Adafruit_SPITFT::SPI_DC_LOW() {}
+void Adafruit_SPITFT::setSPISpeed(uint32_t) {}
+
+//----------------------------------------
+// Adafruit_ILI9341.
+//----------------------------------------
+
+Adafruit_ILI9341::Adafruit_ILI9341(int8_t cs, int8_t dc, int8_t rst)
+  : Adafruit_SPITFT(ILI9341_TFTWIDTH, ILI9341_TFTHEIGHT, cs, dc, rst)
+{
+}
+
+void Adafruit_ILI9341::begin(uint32_t) {}
+void Adafruit_ILI9341::init(uint16_t, uint16_t) {}
+void Adafruit_ILI9341::setRotation(uint8_t m) { Adafruit_GFX::setRotation(m); }
+void Adafruit_ILI9341::invertDisplay(bool) {}
+void Adafruit_ILI9341::setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) { window(x, y, w, h); }
+void Adafruit_ILI9341::scrollTo(uint16_t) {}
+void Adafruit_ILI9341::setScrollMargins(uint16_t, uint16_t) {}
+uint8_t Adafruit_ILI9341::readcommand8(uint8_t, uint8_t) { return 0; }
@@ -0,0 +1,172 @@
+// Host runtime for the host tests, see host.h.
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include "host.h"
+
+uint32_t host_us = 0;
+uint32_t host_irq_latency = 0;
+int host_serial_room = 64;
+int host_failed = 0;
+
+usb_serial_class Serial;
+static int host_fd = -1;
+
+#define HOST_TIMERS   4
+static IntervalTimer *host_timers[HOST_TIMERS];
+
+//----------------------------------------
+// Print, on top of write() as on the Teensy.
+//----------------------------------------
+
+size_t Print::write(const uint8_t *buff, size_t len)
+{
+  size_t done = 0;
+
+  while ((done < len) && write(buff[done]))
+    ++done;
+  return done;
+}
+
+size_t Print::print(const char *s) { return write(s); }
+size_t Print::print(char c) { return write((uint8_t) c); }
+size_t Print::print(int n) { return printf("%d", n); }
+size_t Print::print(unsigned long n) { return printf("%lu", n); }
+size_t Print::println(const char *s) { return print(s) + println(); }
+size_t Print::println() { return write("\r\n"); }
+
+int Print::printf(const char *format, ...)
+{
+  char buff[1024];
+  va_list aptr;
+
+  va_start(aptr, format);
+  int len = vsnprintf(buff, sizeof(buff), format, aptr);
+  va_end(aptr);
+
+  return write((const uint8_t *) buff, min(len, (int) sizeof(buff) - 1));
+}
+
+//----------------------------------------
+// Serial, on a file descriptor.
+//----------------------------------------
+
+void host_serial(int fd)
+{
+  host_fd = fd;
+}
+
+int usb_serial_class::available()
+{
+  int count = 0;
+
+  if ((host_fd < 0) || (ioctl(host_fd, FIONREAD, &count) < 0))
+    return 0;
+  return count;
+}
+
+int usb_serial_class::read()
+{
+  uint8_t ch;
+
+  if (!available() || (::read(host_fd, &ch, 1) != 1))
+    return -1;
+  return ch;
+}
+
+int usb_serial_class::peek()
+{
+  return -1;
+}
+
+int usb_serial_class::availableForWrite()
+{
+  return (host_fd < 0) ? 0 : host_serial_room;
+}
+
+void usb_serial_class::flush()
+{
+}
+
+size_t usb_serial_class::write(uint8_t ch)
+{
+  return write(&ch, 1);
+}
+
+size_t usb_serial_class::write(const uint8_t *buff, size_t len)
+{
+  if (host_fd < 0)
+    return 0;
+
+  len = min(len, (size_t) host_serial_room);
+  ssize_t done = ::write(host_fd, buff, len);
+  return (done < 0) ? 0 : done;
+}
+
+//----------------------------------------
+// The simulated clock and interval timers.
+//----------------------------------------
+
+unsigned long micros() { return host_us; }
+unsigned long millis() { return host_us / 1000; }
+void delay(unsigned long ms) { host_advance(ms * 1000); }
+void delayMicroseconds(unsigned int us) { host_advance(us); }
+void yield(void) { host_advance(HOST_YIELD_US); }
+
+bool IntervalTimer::begin(void (*f)(), unsigned int us)
+{
+  for (int i = 0; i < HOST_TIMERS; ++i)
+    if (!host_timers[i] || (host_timers[i] == this))
+    {
+      func = f;
+      period = us;
+      next = host_us + us;
+      host_timers[i] = this;
+      return true;
+    }
+  return false;
+}
+
+void IntervalTimer::end()
+{
+  for (int i = 0; i < HOST_TIMERS; ++i)
+    if (host_timers[i] == this)
+      host_timers[i] = NULL;
+}
+
+//----------------------------------------
+// Move the clock on, running timer handlers as they fall due.
+//     us  microseconds to move on
+//----------------------------------------
+
+void host_advance(uint32_t us)
+{
+  uint32_t end = host_us + us;
+
+  while (true)
+  {
+    // the earliest timer due by 'end'
+    IntervalTimer *due = NULL;
+
+    for (int i = 0; i < HOST_TIMERS; ++i)
+    {
+      IntervalTimer *t = host_timers[i];
+
+      if (t && ((int32_t) (end - t->next) >= 0) &&
+          (!due || ((int32_t) (t->next - due->next) < 0)))
+        due = t;
+    }
+    if (!due)
+      break;
+
+    uint32_t tick = due->next;
+
+    due->next += due->period;
+    host_us = tick + ((host_irq_latency) ? rand() % (host_irq_latency + 1) : 0);
+    due->func();
+  }
+
+  if ((int32_t) (end - host_us) > 0)
+    host_us = end;
+}
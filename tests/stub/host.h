@@ -0,0 +1,31 @@
+#pragma once
+// Host side controls for the host tests.
+//
+// The clock only moves when a test moves it.  host_advance() runs any
+// IntervalTimer handler that falls due on the way, each one late by a
+// random latency of up to 'host_irq_latency' microseconds.  The hardware
+// timer it stands in for reloads on its own, so the latency of one tick
+// doesn't move the next.
+//
+// The sketch calls yield() while it busy-waits, which moves the clock on
+// HOST_YIELD_US, so its timeouts run out.
+//
+// Serial reads and writes the file descriptor given to host_serial(),
+// at most 'host_serial_room' bytes at a time, as a USB buffer would.
+#include <Arduino.h>
+
+#define HOST_YIELD_US   10          // time passed in one yield() (us)
+
+extern uint32_t host_us;            // the simulated clock (microseconds)
+extern uint32_t host_irq_latency;   // most latency of a timer handler (us)
+extern int host_serial_room;        // bytes Serial takes in one write
+
+void host_advance(uint32_t us);
+void host_serial(int fd);
+
+// report a test result, 'host_failed' counts the failures
+extern int host_failed;
+#define CHECK(cond, ...)                                \
+  do { if (!(cond)) { ++host_failed;                    \
+         printf("FAIL %s:%d: ", __FILE__, __LINE__);    \
+         printf(__VA_ARGS__); printf("\n"); } } while (0)
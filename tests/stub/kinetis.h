@@ -0,0 +1,51 @@
+#pragma once
+// Host stand-in for <kinetis.h>, declarations only, for the host tests.
+#include <stdint.h>
+#define __MK20DX256__ 1
+extern volatile uint32_t ARM_DWT_CYCCNT, ARM_DWT_CTRL, ARM_DEMCR, SIM_SCGC3, SIM_SCGC6, SIM_SOPT4, PORTB_PCR16, PORTB_PCR18, PORTB_PCR19;
+extern volatile uint32_t FTM2_SC, FTM2_CNT, FTM2_MOD, FTM2_C0SC, FTM2_C1SC, FTM2_C0V, FTM2_C1V, FTM2_CNTIN, FTM2_MODE, FTM2_FILTER;
+extern volatile uint32_t SPI0_PUSHR, SPI0_SR, SPI0_RSER, SPI0_MCR, SPI0_CTAR0, SPI0_CTAR1;
+#define ARM_DWT_CTRL_CYCCNTENA (1<<0)
+#define ARM_DEMCR_TRCENA (1<<24)
+#define SIM_SCGC3_FTM2 (1<<24)
+#define PORT_PCR_MUX(n) ((n)<<8)
+#define FTM_SC_CLKS(n) ((n)<<3)
+#define FTM_SC_PS(n) (n)
+#define FTM_SC_TOIE 0x40
+#define FTM_SC_TOF 0x80
+#define FTM_CSC_CHIE 0x40
+#define FTM_CSC_CHF 0x80
+#define FTM_CSC_ELSA 0x04
+#define FTM_CSC_ELSB 0x08
+#define FTM_MODE_WPDIS 0x04
+#define FTM_MODE_FTMEN 0x01
+#define IRQ_FTM2 64
+#define NVIC_ENABLE_IRQ(n) ((void)(n))
+#define NVIC_DISABLE_IRQ(n) ((void)(n))
+#define NVIC_SET_PRIORITY(n,p) ((void)(n))
+#define SPI_PUSHR_CONT (1u<<31)
+#define SPI_PUSHR_CTAS(n) ((n)<<28)
+#define SPI_PUSHR_PCS(n) ((n)<<16)
+#define SPI_SR_TCF (1u<<31)
+#define SPI_SR_TFFF (1u<<25)
+#define SPI_SR_TXCTR (0xF000)
+#define SPI_SR_EOQF (1u<<28)
+#define SPI_PUSHR_EOQ (1u<<27)
+#define SPI_RSER_TFFF_RE (1u<<25)
+#define SPI_RSER_TFFF_DIRS (1u<<24)
+#define SPI_MCR_CLR_TXF (1<<11)
+#define SPI_MCR_CLR_RXF (1<<10)
+#define SPI_MCR_MSTR (1u<<31)
+#define SPI_MCR_PCSIS(n) ((n)<<16)
+#define SPI_CTAR_FMSZ(n) ((n)<<27)
+#define DMAMUX_SOURCE_SPI0_TX 17
+#define SMC_PMPROT 0
+extern volatile uint32_t CORE_PIN0_CONFIG, CORE_PIN25_CONFIG, SIM_SOPT4;
+#define SIM_SOPT4_FTM2CLKSEL (1<<26)
+#ifdef __cplusplus
+extern "C" {
+#endif
+void ftm2_isr(void);
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,240 @@
+////////////////////////////////////////////////////////////////////////////////
+// Host test of the CAT engine, see cat.h.
+//
+// Serial is the slave side of a pseudo-terminal and the test is the host
+// program on the master side, so commands and replies pass through a real
+// tty as they would through the USB serial port.  The VFO side is driven
+// as the event loops drive it, cat_poll() then console_drain().  The rest
+// of the VFO is replaced by fakes that record what CAT asked for.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/ioctl.h>
+#include <string>
+#include "host.h"
+#include "console.h"
+#include "cat.h"
+#include "eeprom.h"
+#include "backup.h"
+#include "render.h"
+
+static int master;                  // the host side of the pty
+static int slave;                   // the VFO side, Serial
+static std::string replies;         // what the host has read
+
+//----------------------------------------
+// The fake VFO.
+//----------------------------------------
+
+Frequency frequency = 7100000;
+VFORegister vfo_reg[2] = {{7100000}, {14200000}};
+int vfo_active = VFO_A;
+bool vfo_split = false;
+unsigned long boot_time = 1234567;
+static Frequency slots[NumSaveSlots];
+static uint8_t marked = 0;          // render_mark() parts since last look
+
+void vfo_set_freq(int reg, Frequency freq)
+{
+  vfo_reg[reg].freq = freq;
+  if (reg == vfo_active)
+    frequency = freq;
+}
+
+void vfo_select(int reg)
+{
+  vfo_reg[vfo_active].freq = frequency;
+  vfo_active = reg;
+  frequency = vfo_reg[reg].freq;
+}
+
+void render_mark(uint8_t parts) { marked |= parts; }
+void slot_get(int slot, Frequency &freq, SelOffset &offset) { freq = slots[slot]; offset = 0; }
+void slot_put(int slot, Frequency freq, SelOffset) { slots[slot] = freq; }
+
+void mirror_start(void) {}
+void mirror_stop(void) {}
+void latency_report(void) { console.printf("ZL0;"); }
+void latency_reset(void) {}
+void idle_report(void) { console.printf("ZI0;"); }
+void idle_reset(void) {}
+void fill_report(void) { console.printf("ZF0;"); }
+void fill_reset(void) {}
+void spi_report(void) { console.printf("ZS0;"); }
+void spi_reset(void) {}
+void profile_report(void) { console.printf("ZP0,0,0,0,0;"); }
+void profile_reset(void) {}
+bool backup_read(const char *, int, char *) { return false; }
+bool backup_write(const char *, int, char *) { return false; }
+int backup_commit(void) { return -1; }
+int snapshot_count(void) { return 42; }
+bool snapshot_take(int) { return false; }
+void monitor_report(void) { console.printf("ZV0,0,0,0;"); }
+
+//----------------------------------------
+// Send bytes from the host, and wait until the VFO side can read them.
+//     data  address of the bytes
+//     len   number of bytes
+// Returns the number sent, the pty may not take them all.
+//----------------------------------------
+
+static int send(const char *data, int len)
+{
+  int before = Serial.available();
+  ssize_t sent = write(master, data, len);
+
+  if (sent <= 0)
+    return 0;
+
+  struct pollfd pfd = {slave, POLLIN, 0};
+
+  for (int i = 0; (i < 100) && (Serial.available() < before + sent); ++i)
+    poll(&pfd, 1, 10);
+  return sent;
+}
+
+//----------------------------------------
+// Run the VFO side until the input is used up and the output sent, and
+// the host has read at least 'want' reply bytes, or 1 second passes.
+//     want  reply bytes expected
+// Returns the most bytes cat_poll() took in one call.
+//----------------------------------------
+
+static int run(size_t want)
+{
+  int most = 0;
+  int idle = 0;
+
+  while (idle < 100)
+  {
+    int before = Serial.available();
+
+    cat_poll();
+    console_drain();
+    most = max(most, before - Serial.available());
+
+    char buff[256];
+    ssize_t len;
+    bool got = false;
+
+    while ((len = read(master, buff, sizeof(buff))) > 0)
+    {
+      replies.append(buff, len);
+      got = true;
+    }
+
+    if (!Serial.available() && !console_pending() && (replies.size() >= want))
+      break;
+
+    // the pty moves data in its own time
+    if (!got && !Serial.available())
+    {
+      struct pollfd pfd = {master, POLLIN, 0};
+
+      poll(&pfd, 1, 10);
+      ++idle;
+    }
+  }
+
+  return most;
+}
+
+//----------------------------------------
+// Send commands from the host and check the replies.
+//     cmds    the commands, as the host program sends them
+//     expect  the replies expected
+//----------------------------------------
+
+static void command(const char *cmds, const char *expect)
+{
+  replies.clear();
+  send(cmds, strlen(cmds));
+  run(strlen(expect));
+  CHECK(replies == expect, "'%s' replied '%s', expected '%s'", cmds, replies.c_str(), expect);
+}
+
+int main(void)
+{
+  // a raw pty, the VFO side is Serial
+  master = posix_openpt(O_RDWR | O_NOCTTY);
+  grantpt(master);
+  unlockpt(master);
+
+  slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+  struct termios tio;
+
+  tcgetattr(slave, &tio);
+  cfmakeraw(&tio);
+  tcsetattr(slave, TCSANOW, &tio);
+  fcntl(master, F_SETFL, O_NONBLOCK);
+  fcntl(slave, F_SETFL, O_NONBLOCK);
+  host_serial(slave);
+
+  // the commands
+  command("ID;", CAT_ID);
+  command("FA;", "FA00007100000;");
+  command("FA00003500000;FA;FB;", "FA00003500000;FB00014200000;");
+  command("FR1;FR;FA;FB;", "FR1;FA00003500000;FB00014200000;");
+  CHECK(frequency == 14200000, "FR1: frequency %lu", frequency);
+  command("FR0;FT1;FT;", "FT1;");
+  CHECK(vfo_split && (marked & RD_AB), "FT1: split not shown");
+  command("FT0;FT;", "FT0;");
+  command("MW00300010100000;MR003;", "MR00300010100000;");
+  command("ZT;ZB;AI;PS;", "ZT042;ZB01234567;AI0;PS1;");
+  command("ZL;ZI;ZF;ZS;ZV;ZP;ZP0;", "ZL0;ZI0;ZF0;ZS0;ZV0,0,0,0;ZP0,0,0,0,0;");
+
+  // bad commands
+  command("XX;", "?;");
+  command("FA123;", "?;");
+  command("FA00100000000;", "?;");
+  command("FR2;", "?;");
+  command("MR010;", "?;");
+  command("ZPX;", "?;");
+  command(";", "?;");
+  command("FAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA;FA;",
+          "?;FA00003500000;");
+
+  // lower case, line ends and a command split across writes
+  command("fa;\r\n", "FA00003500000;");
+  command("FA0000", "");
+  command("7000000;\nFA", "");
+  command(";", "FA00007000000;");
+
+  // a flood of commands through a USB buffer that takes a few bytes a
+  // time: every reply arrives, in order, and cat_poll() never takes more
+  // than CAT_MAX_POLL bytes in one call
+  std::string flood;
+  std::string expect;
+
+  for (int i = 0; i < 2000; ++i)
+  {
+    char cmd[32];
+
+    sprintf(cmd, "FA%011d;", 1000000 + i);
+    flood += cmd;
+    flood += "FA;";
+    expect += cmd;
+  }
+
+  host_serial_room = 4;
+  replies.clear();
+
+  size_t done = 0;
+  int most = 0;
+
+  while (done < flood.size())
+  {
+    done += send(flood.data() + done, min((size_t) 1024, flood.size() - done));
+    most = max(most, run(0));
+  }
+  most = max(most, run(expect.size()));
+  CHECK(replies == expect, "flood: %zu reply bytes, expected %zu", replies.size(), expect.size());
+  CHECK(most <= CAT_MAX_POLL, "flood: %d bytes in one cat_poll()", most);
+  CHECK(console_dropped() == 0, "%lu writes dropped", console_dropped());
+
+  printf("test_cat: %s\n", (host_failed) ? "FAILED" : "passed");
+  return (host_failed) ? 1 : 0;
+}
@@ -0,0 +1,147 @@
+////////////////////////////////////////////////////////////////////////////////
+// Host test of the serial console, see console.h.
+//
+// Binary messages, built a byte at a time as the mirror builds them, are
+// mixed with text writes and drained in small pieces into a pipe.  What
+// comes out of the pipe must be exactly the messages that were accepted,
+// each one whole, in order.  Then the host stops reading, and writes must
+// time out once and be dropped at once after that.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <string>
+#include "host.h"
+#include "console.h"
+
+static int pipe_fd[2];
+static std::string sent;        // the accepted messages, in order
+static std::string received;    // what came out of the pipe
+
+//----------------------------------------
+// Read everything waiting in the pipe.
+//----------------------------------------
+
+static void receive(void)
+{
+  char buff[1024];
+  ssize_t len;
+
+  while ((len = read(pipe_fd[0], buff, sizeof(buff))) > 0)
+    received.append(buff, len);
+}
+
+//----------------------------------------
+// Send a binary message, as the mirror does.
+//     len   number of payload bytes
+//     wait  ms the message may wait for room
+// Returns 'true' if it was accepted.
+//----------------------------------------
+
+static bool binary(int len, uint32_t wait)
+{
+  std::string msg = "\xA5\x5AR";
+
+  for (int i = 0; i < len; ++i)
+    msg += (char) rand();
+
+  console_begin(wait);
+  for (char ch : msg)
+    console_byte(ch);
+  if (!console_end())
+    return false;
+  sent += msg;
+  return true;
+}
+
+//----------------------------------------
+// Send a text message.
+//     num  number to put in it
+// Returns 'true' if it was accepted.
+//----------------------------------------
+
+static bool text(int num)
+{
+  char msg[64];
+  int len = snprintf(msg, sizeof(msg), "text message %d;\n", num);
+
+  if (console.printf("text message %d;\n", num) != len)
+    return false;
+  sent += msg;
+  return true;
+}
+
+int main(void)
+{
+  pipe(pipe_fd);
+  fcntl(pipe_fd[0], F_SETFL, O_NONBLOCK);
+  fcntl(pipe_fd[1], F_SETFL, O_NONBLOCK);
+  host_serial(pipe_fd[1]);
+
+  // mixed messages, drained a few bytes at a time
+  int dropped = 0;
+
+  srand(1);
+  for (int i = 0; i < 20000; ++i)
+  {
+    if (rand() % 3)
+      dropped += !binary(rand() % 300, 0);
+    else
+      dropped += !text(i);
+
+    host_serial_room = 1 + rand() % 64;
+    if (rand() % 4 == 0)
+      console_drain();
+    if (rand() % 8 == 0)
+      receive();
+  }
+  host_serial_room = 64;
+  console.flush();
+  receive();
+
+  CHECK(console_pending() == 0, "mixed: %d bytes not sent", console_pending());
+  CHECK(dropped > 0, "mixed: buffer never filled");
+  CHECK(received == sent, "mixed: %zu bytes sent, %zu received, differ at %zu",
+        sent.size(), received.size(),
+        (size_t) (std::mismatch(sent.begin(), sent.end(), received.begin()).first - sent.begin()));
+
+  // a message bigger than the buffer is dropped without waiting
+  uint32_t start = host_us;
+
+  CHECK(!binary(CONSOLE_BUFF_SIZE, 1000), "huge message accepted");
+  CHECK(host_us == start, "huge message waited %luus", (unsigned long) (host_us - start));
+
+  // the host stops reading, the first write to find the buffer full waits
+  // CONSOLE_WAIT_MS, then writes are dropped at once
+  unsigned long drops = console_dropped();
+  int num = 0;
+
+  host_serial_room = 0;
+  start = host_us;
+  while (text(num))
+    ++num;
+  CHECK(num > 0, "stalled: nothing buffered");
+  CHECK(host_us - start >= (CONSOLE_WAIT_MS - 1) * 1000UL, "stalled: waited only %luus",
+        (unsigned long) (host_us - start));
+  CHECK(host_us - start < (CONSOLE_WAIT_MS + 1) * 1000UL, "stalled: waited %luus",
+        (unsigned long) (host_us - start));
+
+  start = host_us;
+  CHECK(!text(num) && !text(num + 1), "stalled: text accepted");
+  CHECK(!binary(10, 1000), "stalled: binary accepted");
+  CHECK(host_us == start, "stalled: waited again %luus", (unsigned long) (host_us - start));
+  CHECK(console_dropped() == drops + 3, "stalled: %lu drops counted",
+        console_dropped() - drops);
+
+  // the host reads again, nothing accepted is lost
+  host_serial_room = 64;
+  console_drain();
+  CHECK(text(num + 2), "restarted: text dropped");
+  console.flush();
+  receive();
+  CHECK(received == sent, "restarted: %zu bytes sent, %zu received", sent.size(), received.size());
+
+  printf("test_console: %s\n", (host_failed) ? "FAILED" : "passed");
+  return (host_failed) ? 1 : 0;
+}
@@ -0,0 +1,167 @@
+////////////////////////////////////////////////////////////////////////////////
+// Host test of the rotary encoder decoder, see encoder.h.
+//
+// Synthetic quadrature edge streams are fed to encoder_edge() at rates far
+// beyond any real knob, and 'encoder_total' is checked against the detents
+// sent, with the acceleration worked out here from the detent times.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "host.h"
+#include "encoder.h"
+
+// pin states, B << 1 | A, in the order one detent clockwise passes them
+static const uint8_t cw_states[ENCODER_QUARTERS] = {2, 3, 1, 0};
+
+static uint8_t pins = 0;            // pin state last sent
+static int phase = 0;               // position of 'pins' in 'cw_states'
+static uint32_t now = 0;            // time of last edge (us)
+static uint32_t last_detent = 0;    // time of last whole detent (us)
+static int32_t expected = 0;        // what 'encoder_total' should be
+
+//----------------------------------------
+// The accelerated step count for a detent, as encoder.h describes it.
+//     interval  microseconds since the last detent
+//----------------------------------------
+
+static int32_t accel(uint32_t interval)
+{
+  if (interval < ENCODER_ACCEL_US3)
+    return ENCODER_ACCEL3;
+  if (interval < ENCODER_ACCEL_US2)
+    return ENCODER_ACCEL2;
+  if (interval < ENCODER_ACCEL_US1)
+    return ENCODER_ACCEL1;
+  return 1;
+}
+
+//----------------------------------------
+// Send one edge, a quarter-step.
+//     dir  +1 for clockwise, -1 for anticlockwise
+//     gap  microseconds since the last edge
+//----------------------------------------
+
+static void quarter(int dir, uint32_t gap)
+{
+  phase = (phase + dir + ENCODER_QUARTERS) % ENCODER_QUARTERS;
+  pins = cw_states[(phase + ENCODER_QUARTERS - 1) % ENCODER_QUARTERS];
+  now += gap;
+  encoder_edge(pins, now);
+}
+
+//----------------------------------------
+// Send whole detents.
+//     num  number of detents, negative for anticlockwise
+//     gap  microseconds between edges
+//----------------------------------------
+
+static void detents(int num, uint32_t gap)
+{
+  int dir = (num < 0) ? -1 : 1;
+
+  for (int i = 0; i < abs(num); ++i)
+  {
+    for (int q = 0; q < ENCODER_QUARTERS; ++q)
+      quarter(dir, gap);
+    expected += dir * accel(now - last_detent);
+    last_detent = now;
+  }
+}
+
+//----------------------------------------
+// Let the knob rest long enough to end any acceleration.
+//----------------------------------------
+
+static void rest(void)
+{
+  now += 1000000;
+}
+
+//----------------------------------------
+// Check 'encoder_total' and the error count.
+//     what  description of the stream sent
+//----------------------------------------
+
+static void check(const char *what)
+{
+  CHECK(encoder_total == expected, "%s: total %ld, expected %ld",
+        what, (long) encoder_total, (long) expected);
+  CHECK(encoder_errors == 0, "%s: %lu errors", what, (unsigned long) encoder_errors);
+}
+
+int main(void)
+{
+  // slow turns, one step a detent
+  rest();
+  detents(10, 10000);
+  check("slow clockwise");
+  rest();
+  detents(-25, 10000);
+  check("slow anticlockwise");
+
+  // each acceleration band, and the edges between them
+  const uint32_t gaps[] = {ENCODER_ACCEL_US1 / ENCODER_QUARTERS,
+                           ENCODER_ACCEL_US1 / ENCODER_QUARTERS - 1,
+                           ENCODER_ACCEL_US2 / ENCODER_QUARTERS,
+                           ENCODER_ACCEL_US2 / ENCODER_QUARTERS - 1,
+                           ENCODER_ACCEL_US3 / ENCODER_QUARTERS,
+                           ENCODER_ACCEL_US3 / ENCODER_QUARTERS - 1};
+  for (uint32_t gap : gaps)
+  {
+    rest();
+    detents(200, gap);
+    detents(-150, gap);
+  }
+  check("acceleration bands");
+
+  // high rates, down to an edge every microsecond
+  for (uint32_t gap = 50; gap > 0; gap /= 2)
+  {
+    rest();
+    detents(5000, gap);
+    detents(-7000, gap);
+  }
+  check("high rate");
+
+  // across the wrap of the microsecond clock
+  now = 0xFFFFFFFFUL - 10 * ENCODER_QUARTERS;
+  last_detent = now - 1000000;
+  detents(40, 1);
+  check("clock wrap");
+
+  // contact bounce, forward and back within a detent counts nothing
+  rest();
+  for (int i = 0; i < 10000; ++i)
+  {
+    quarter(1, 1);
+    quarter(-1, 1);
+  }
+  check("bounce");
+  detents(3, 100000);
+  check("after bounce");
+
+  // the main loop draining the count while edges arrive loses nothing
+  int32_t taken = encoder_take();
+  int32_t start = encoder_total;
+  int32_t drained = 0;
+
+  rest();
+  for (int i = 0; i < 100000; ++i)
+  {
+    quarter((i % 3000 < 2000) ? 1 : -1, 2);
+    if (i % 37 == 0)
+      drained += encoder_take();
+  }
+  drained += encoder_take();
+  CHECK(drained == encoder_total - start, "drain: took %ld of %ld (first take %ld)",
+        (long) drained, (long) (encoder_total - start), (long) taken);
+
+  // a skipped state is an error and no step
+  int32_t total = encoder_total;
+
+  encoder_edge(pins ^ 3, now + 1);
+  CHECK(encoder_errors == 1, "skipped state: %lu errors", (unsigned long) encoder_errors);
+  CHECK(encoder_total == total, "skipped state: total moved");
+
+  printf("test_encoder: %s\n", (host_failed) ? "FAILED" : "passed");
+  return (host_failed) ? 1 : 0;
+}
@@ -0,0 +1,405 @@
+////////////////////////////////////////////////////////////////////////////////
+// Host test of the screen snapshots, see snapshot.h.
+//
+// Usage: test_snapshot [-u]
+//
+// The whole sketch runs on the framebuffer display in stub/gfx.cpp.  After
+// setup() each scenario is drawn in a child process of its own, so no
+// scenario sees what another left behind, with one child for each CPU at a
+// time.  A child rebuilds its screen from the mirror stream, as
+// tools/snapshot_check.py does, and compares it with
+// snapshots/<width>x<height>/<name>.ppm.  The main screen is also compared
+// with the framebuffer, which checks the mirror stream against what was
+// drawn.
+//
+// A scenario with no reference image fails.  For each failure the screen
+// drawn is written to snapshot_out/, with a '-diff' image showing the
+// differing pixels in red.  With -u every screen is saved as the new
+// reference, to be checked by eye and committed.
+//
+// The references are made here, with the stand-in fonts, so they are not
+// the ones snapshot_check.py compares a real VFO with.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "host.h"
+#include "PixelVFO.h"
+#include "mirror.h"
+#include "snapshot.h"
+#include "console.h"
+
+#define REFERENCE   "snapshots"     // reference images, by screen size
+#define OUT_DIR     "snapshot_out"  // failing screens
+#define SKIP        0x8000
+
+void setup(void);
+
+static bool update = false;     // 'true' to save the references
+
+//----------------------------------------
+// A screen rebuilt from the mirror stream.
+//----------------------------------------
+
+struct Screen
+{
+  int width = 0;
+  int height = 0;
+  std::vector<uint16_t> pixels;
+};
+
+static uint16_t get_u16(const std::string &s, size_t pos)
+{
+  return (uint8_t) s[pos] | ((uint8_t) s[pos + 1] << 8);
+}
+
+//----------------------------------------
+// Rebuild the screen a scenario drew.
+//     stream  everything sent to Serial
+//     num     the scenario number
+//     screen  the screen to fill in
+//     name    the name from the scenario's marker
+// Returns 'false' if the stream ends before the marker.
+//----------------------------------------
+
+static bool rebuild(const std::string &stream, int num, Screen &screen, std::string &name)
+{
+  size_t pos = 0;
+
+  while ((pos = stream.find("\xA5\x5A", pos)) != std::string::npos)
+  {
+    char kind = (pos + 2 < stream.size()) ? stream[pos + 2] : 0;
+
+    pos += 3;
+    if (kind == 'F')
+    {
+      screen.width = get_u16(stream, pos);
+      screen.height = get_u16(stream, pos + 2);
+      screen.pixels.assign(screen.width * screen.height, 0);
+      pos += 4;
+    }
+    else if (kind == 'R')
+    {
+      int x = get_u16(stream, pos);
+      int y = get_u16(stream, pos + 2);
+      int w = get_u16(stream, pos + 4);
+      int h = get_u16(stream, pos + 6);
+      long ndx = 0;
+
+      pos += 8;
+      while (ndx < (long) w * h)
+      {
+        uint16_t count = get_u16(stream, pos);
+        bool skip = count & SKIP;
+        uint16_t color = (skip) ? 0 : get_u16(stream, pos + 2);
+
+        pos += (skip) ? 2 : 4;
+        for (count &= ~SKIP; count > 0; --count, ++ndx)
+        {
+          int px = x + ndx % w;
+          int py = y + ndx / w;
+
+          if (!skip && (px < screen.width) && (py < screen.height))
+            screen.pixels[py * screen.width + px] = color;
+        }
+      }
+    }
+    else if (kind == 'M')
+    {
+      int id = get_u16(stream, pos);
+      int len = (uint8_t) stream[pos + 2];
+
+      pos += 3 + len;
+      if (id == num)
+      {
+        name = stream.substr(pos - len, len);
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+//----------------------------------------
+// Read or write a whole file.
+//----------------------------------------
+
+static bool read_file(const std::string &path, std::string &data)
+{
+  FILE *f = fopen(path.c_str(), "rb");
+  char buff[4096];
+  size_t len;
+
+  if (!f)
+    return false;
+  data.clear();
+  while ((len = fread(buff, 1, sizeof(buff), f)) > 0)
+    data.append(buff, len);
+  fclose(f);
+  return true;
+}
+
+static void write_file(const std::string &path, const std::string &data)
+{
+  FILE *f = fopen(path.c_str(), "wb");
+
+  CHECK(f && (fwrite(data.data(), 1, data.size(), f) == data.size()), "can't write %s", path.c_str());
+  if (f)
+    fclose(f);
+}
+
+//----------------------------------------
+// Make a PPM image of a screen, as snapshot_check.py does.
+//----------------------------------------
+
+static std::string ppm(const Screen &screen)
+{
+  char header[32];
+  std::string image;
+
+  snprintf(header, sizeof(header), "P6 %d %d 255\n", screen.width, screen.height);
+  image = header;
+  for (uint16_t c : screen.pixels)
+  {
+    image += (char) (((c >> 11) & 0x1F) << 3);
+    image += (char) (((c >> 5) & 0x3F) << 2);
+    image += (char) ((c & 0x1F) << 3);
+  }
+  return image;
+}
+
+//----------------------------------------
+// Compare an image with its reference, both the same size.
+//     image   the image drawn
+//     golden  the reference image
+//     diff    filled in with the differing pixels in red, the rest darkened
+//     result  filled in with the number of differing pixels and their bounds
+//----------------------------------------
+
+static void compare(const std::string &image, const std::string &golden, int width,
+                    std::string &diff, char *result, int size)
+{
+  size_t start = image.find('\n') + 1;
+  int count = 0, x1 = width, y1 = 1 << 16, x2 = -1, y2 = -1;
+
+  diff = image;
+  for (size_t i = start; i < image.size(); i += 3)
+  {
+    if (image.compare(i, 3, golden, i, 3) == 0)
+    {
+      for (int j = 0; j < 3; ++j)
+        diff[i + j] = (uint8_t) image[i + j] / 4;
+    }
+    else
+    {
+      int x = (i - start) / 3 % width;
+      int y = (i - start) / 3 / width;
+
+      diff.replace(i, 3, "\xFF\x00\x00", 3);
+      ++count;
+      x1 = min(x1, x);
+      y1 = min(y1, y);
+      x2 = max(x2, x);
+      y2 = max(y2, y);
+    }
+  }
+  snprintf(result, size, "%d pixels differ in (%d,%d)-(%d,%d)", count, x1, y1, x2, y2);
+}
+
+//----------------------------------------
+// Draw one scenario and check it, in a child process.  Writes the
+// scenario's file name as the first line, then its result.
+//     num  the scenario number
+// Returns the exit status for the child.
+//----------------------------------------
+
+static int check(int num)
+{
+  FILE *serial = tmpfile();
+  std::string stream;
+  Screen screen;
+  std::string name;
+
+  host_serial(fileno(serial));
+  host_serial_room = 1 << 20;
+
+  // the main screen is redrawn afterwards in the state the VFO was in, so
+  // in the state every scenario shows it is the same screen again
+  frequency = SNAPSHOT_FREQ;
+  freq_digit_select = -1;
+  vfo_state = VFO_Standby;
+  vfo_active = VFO_A;
+  vfo_split = false;
+
+  mirror_start();
+  mirror_poll();
+  CHECK(snapshot_take(num), "scenario %d not taken", num);
+  console.flush();
+
+  rewind(serial);
+  char buff[4096];
+  size_t len;
+  while ((len = fread(buff, 1, sizeof(buff), serial)) > 0)
+    stream.append(buff, len);
+
+  if (!rebuild(stream, num, screen, name) || (screen.width == 0))
+  {
+    printf("%d\n", num);
+    CHECK(false, "scenario %d: no marker or no full frame in the stream", num);
+    return 1;
+  }
+
+  // the file name, made safe as snapshot_check.py does
+  for (char &ch : name)
+    if (!isalnum((uint8_t) ch) && (ch != '_') && (ch != '-'))
+      ch = '_';
+  printf("%s\n", name.c_str());
+
+  // the main screen is also in the framebuffer
+  if (num == 0)
+  {
+    int wrong = 0;
+
+    for (int y = 0; y < screen.height; ++y)
+      for (int x = 0; x < screen.width; ++x)
+        wrong += (screen.pixels[y * screen.width + x] != tft.pixel(x, y));
+    CHECK(wrong == 0, "%s: %d pixels of the mirror stream differ from the display", name.c_str(), wrong);
+  }
+
+  char dir[64];
+  snprintf(dir, sizeof(dir), REFERENCE "/%dx%d", screen.width, screen.height);
+  std::string path = std::string(dir) + "/" + name + ".ppm";
+  std::string image = ppm(screen);
+  std::string golden;
+  std::string diff;
+  char result[80];
+
+  if (update)
+  {
+    mkdir(REFERENCE, 0777);
+    mkdir(dir, 0777);
+    write_file(path, image);
+    printf("%-24s saved\n", name.c_str());
+    return host_failed ? 1 : 0;
+  }
+
+  if (!read_file(path, golden))
+    snprintf(result, sizeof(result), "no reference %s, run test_snapshot -u", path.c_str());
+  else if (golden.size() != image.size())
+    snprintf(result, sizeof(result), "reference is a different size");
+  else if (golden != image)
+    compare(image, golden, screen.width, diff, result, sizeof(result));
+  else
+  {
+    printf("%-24s PASS\n", name.c_str());
+    return host_failed ? 1 : 0;
+  }
+
+  ++host_failed;
+  printf("%-24s FAIL, %s\n", name.c_str(), result);
+  mkdir(OUT_DIR, 0777);
+  write_file(OUT_DIR "/" + name + ".ppm", image);
+  if (!diff.empty())
+    write_file(OUT_DIR "/" + name + "-diff.ppm", diff);
+  return 1;
+}
+
+//----------------------------------------
+// A running child, reporting on the read end of a pipe.
+//----------------------------------------
+
+struct Child
+{
+  pid_t pid;
+  int fd;
+  int num;
+};
+
+int main(int argc, char *argv[])
+{
+  update = (argc > 1) && !strcmp(argv[1], "-u");
+
+  host_serial(open("/dev/null", O_WRONLY));
+  setup();
+
+  int count = snapshot_count();
+  int jobs = max(1L, sysconf(_SC_NPROCESSORS_ONLN));
+  std::vector<std::string> output(count);
+  std::vector<Child> running;
+  int next = 0;
+
+  fflush(stdout);
+  while ((next < count) || !running.empty())
+  {
+    // start children up to 'jobs' at a time
+    while ((next < count) && ((int) running.size() < jobs))
+    {
+      int fds[2];
+
+      if (pipe(fds) < 0)
+        return 1;
+      pid_t pid = fork();
+
+      if (pid == 0)
+      {
+        close(fds[0]);
+        dup2(fds[1], STDOUT_FILENO);
+        int status = check(next);
+        fflush(stdout);
+        _exit(status);
+      }
+      close(fds[1]);
+      running.push_back({pid, fds[0], next});
+      ++next;
+    }
+
+    // collect whichever child finishes first
+    int status;
+    pid_t pid = wait(&status);
+
+    for (size_t i = 0; i < running.size(); ++i)
+    {
+      if (running[i].pid != pid)
+        continue;
+
+      char buff[4096];
+      ssize_t len;
+      std::string &out = output[running[i].num];
+
+      while ((len = read(running[i].fd, buff, sizeof(buff))) > 0)
+        out.append(buff, len);
+      close(running[i].fd);
+      if (!WIFEXITED(status) || (WEXITSTATUS(status) != 0))
+        ++host_failed;
+      if (!WIFEXITED(status))
+        out += "FAIL child crashed\n";
+      running.erase(running.begin() + i);
+      break;
+    }
+  }
+
+  // results in scenario order, each file name used once
+  std::vector<std::string> names;
+
+  for (int num = 0; num < count; ++num)
+  {
+    const std::string &out = output[num];
+    size_t eol = out.find('\n');
+    std::string name = out.substr(0, eol);
+
+    CHECK(std::find(names.begin(), names.end(), name) == names.end(),
+          "scenario %d: name '%s' used twice", num, name.c_str());
+    names.push_back(name);
+    if (eol != std::string::npos)
+      fputs(out.c_str() + eol + 1, stdout);
+  }
+
+  printf("test_snapshot: %d screens, %s\n", count, (host_failed) ? "FAILED" : "passed");
+  return (host_failed) ? 1 : 0;
+}
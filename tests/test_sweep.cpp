@@ -0,0 +1,132 @@
+////////////////////////////////////////////////////////////////////////////////
+// Host test of the sweep generator, see sweep.h.
+//
+// The DDS is replaced by a recorder of the words loaded and the simulated
+// time of each load.  Every step must be loaded within the interrupt latency
+// of its tick on the dwell grid, with no drift however long the sweep runs.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "host.h"
+#include "sweep.h"
+#include "dds.h"
+
+#define MAX_LOADS   200000
+
+static uint32_t load_word[MAX_LOADS];   // words loaded, in order
+static uint32_t load_time[MAX_LOADS];   // time of each load (us)
+static long loads = 0;                  // number of loads, may pass MAX_LOADS
+
+//----------------------------------------
+// The DDS, a tuning word is the frequency itself.
+//----------------------------------------
+
+uint32_t dds_word(Frequency freq)
+{
+  return freq;
+}
+
+void dds_load_word(uint32_t word)
+{
+  if (loads < MAX_LOADS)
+  {
+    load_word[loads] = word;
+    load_time[loads] = host_us;
+  }
+  ++loads;
+}
+
+//----------------------------------------
+// Run a sweep and check every step loaded.
+//     what     description of the sweep
+//     dwell    dwell to ask for (us)
+//     latency  most interrupt latency (us)
+//     ticks    number of timer ticks to run
+//----------------------------------------
+
+static void run(const char *what, unsigned long dwell, uint32_t latency, long ticks)
+{
+  int len = sweep_prepare();
+
+  loads = 0;
+  host_irq_latency = latency;
+  sweep_dwell = dwell;
+  CHECK(sweep_start(), "%s: not started", what);
+  dwell = sweep_dwell;        // as clamped
+
+  uint32_t start = host_us;
+
+  host_advance(ticks * dwell + dwell / 2);
+  sweep_stop();
+  CHECK(loads == ticks, "%s: %ld loads, expected %ld", what, loads, ticks);
+  CHECK((long) sweep_passes() == ticks / len, "%s: %lu passes, expected %ld",
+        what, sweep_passes(), ticks / len);
+
+  int bad = 0;
+
+  for (long i = 0; (i < loads) && (i < MAX_LOADS) && (bad < 5); ++i)
+  {
+    uint32_t tick = start + (i + 1) * dwell;
+    uint32_t late = load_time[i] - tick;
+    uint32_t word = dds_word(sweep_start_freq + (i % len) * sweep_step_freq);
+
+    if ((late > latency) || (load_word[i] != word))
+    {
+      CHECK(false, "%s: step %ld loaded %lu at %luus, expected %lu at %lu-%luus",
+            what, i, (unsigned long) load_word[i], (unsigned long) load_time[i],
+            (unsigned long) word, (unsigned long) tick, (unsigned long) (tick + latency));
+      ++bad;
+    }
+  }
+
+  // stopped, nothing more is loaded
+  long stopped = loads;
+
+  host_advance(10 * dwell);
+  CHECK(loads == stopped, "%s: %ld loads after stop", what, loads - stopped);
+}
+
+int main(void)
+{
+  // bad parameters
+  sweep_start_freq = 2000000;
+  sweep_stop_freq = 1000000;
+  sweep_step_freq = 1000;
+  CHECK(sweep_prepare() == 0, "reversed sweep prepared");
+  sweep_stop_freq = 3000000;
+  sweep_step_freq = 0;
+  CHECK(sweep_prepare() == 0, "zero step prepared");
+
+  // a short sweep, stop included
+  sweep_start_freq = 1000000;
+  sweep_stop_freq = 1010000;
+  sweep_step_freq = 1000;
+  CHECK(sweep_prepare() == 11, "short sweep: %d steps", sweep_prepare());
+  run("short sweep", 1000, 0, 11 * 20);
+  run("short sweep, latency", 100, 7, 11 * 500 + 3);
+
+  // truncated at SWEEP_MAX_STEPS
+  sweep_stop_freq = 30000000;
+  CHECK(sweep_prepare() == SWEEP_MAX_STEPS, "long sweep: %d steps", sweep_prepare());
+  run("long sweep", 250, 3, SWEEP_MAX_STEPS * 3);
+
+  // dwell clamped to SWEEP_MIN_DWELL, a second at 50000 steps/second, then
+  // long enough for the microsecond clock to wrap, checked at the end
+  sweep_dwell = 1;
+  sweep_start_freq = 7000000;
+  sweep_stop_freq = 7100000;
+  sweep_step_freq = 100;
+  run("fastest", 1, 5, 1000000 / SWEEP_MIN_DWELL);
+  CHECK(sweep_dwell == SWEEP_MIN_DWELL, "dwell %lu not clamped", sweep_dwell);
+
+  host_us = 0xFFFFFFFFUL - 1000000;
+  run("clock wrap", SWEEP_MIN_DWELL, 5, 2000000 / SWEEP_MIN_DWELL);
+
+  // a sweep can't be started twice
+  CHECK(sweep_start(), "restart: not started");
+  CHECK(!sweep_start(), "restart: started twice");
+  sweep_stop();
+  CHECK(!sweep_running(), "restart: still running");
+
+  printf("test_sweep: %s\n", (host_failed) ? "FAILED" : "passed");
+  return (host_failed) ? 1 : 0;
+}
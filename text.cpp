@@ -0,0 +1,155 @@
+////////////////////////////////////////////////////////////////////////////////
+// Text measurement and layout for PixelVFO.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "PixelVFO.h"
+#include "text.h"
+
+// one cached label width
+struct TextCache
+{
+  const GFXfont *font;
+  const char *label;
+  int width;
+};
+
+static TextCache text_cache[TEXT_CACHE_SIZE];
+
+//----------------------------------------
+// Get the advance of one character, 0 if not in the font.
+//----------------------------------------
+
+static inline int text_advance(const GFXfont *font, uint8_t ch)
+{
+  if ((ch < font->first) || (ch > font->last))
+    return 0;
+  return font->glyph[ch - font->first].xAdvance;
+}
+
+//----------------------------------------
+// Measure a string.
+//     font  the font the string will be drawn in
+//     str   address of the string
+//     len   number of chars to measure, -1 means all
+// Returns the width in pixels.
+//----------------------------------------
+
+int text_width(const GFXfont *font, const char *str, int len)
+{
+  int width = 0;
+
+  for (const char *p = str; *p && (len-- != 0); ++p)
+    width += text_advance(font, *p);
+
+  return width;
+}
+
+//----------------------------------------
+// Measure an unchanging label, using the cache.
+//     font   the font the label will be drawn in
+//     label  address of the label
+// Returns the width in pixels.
+//----------------------------------------
+
+int text_label_width(const GFXfont *font, const char *label)
+{
+  uintptr_t hash = ((uintptr_t) label >> 2) ^ ((uintptr_t) font >> 4);
+  TextCache *entry = &text_cache[hash & (TEXT_CACHE_SIZE - 1)];
+
+  if ((entry->label != label) || (entry->font != font))
+  {
+    entry->font = font;
+    entry->label = label;
+    entry->width = text_width(font, label, -1);
+  }
+
+  return entry->width;
+}
+
+//----------------------------------------
+// Drop any cached widths of a label that has changed.
+//     label  address of the label
+//----------------------------------------
+
+void text_forget(const char *label)
+{
+  for (int i = 0; i < TEXT_CACHE_SIZE; ++i)
+  {
+    if (text_cache[i].label == label)
+      text_cache[i].label = NULL;
+  }
+}
+
+//----------------------------------------
+// Draw text word-wrapped into a box.
+//     font       the font to draw in
+//     str        address of the text, '\n' forces a new line
+//     x, y       left end of the first line's baseline
+//     w          width of the box
+//     max_lines  most lines to draw, 0 means no limit
+// Lines are broken at spaces, or within a word too long for a line.
+// Returns the number of lines drawn.
+//----------------------------------------
+
+int text_draw_wrapped(const GFXfont *font, const char *str,
+                      int x, int y, int w, int max_lines)
+{
+  const char *line = str;       // start of the current line
+  const char *brk = NULL;       // last space in the current line
+  int line_w = 0;               // width of the line before 'p'
+  int brk_w = 0;                // width of the line before 'brk'
+  int lines = 0;
+
+  tft.setFont(font);
+
+  for (const char *p = str; ; ++p)
+  {
+    bool end = ((*p == '\0') || (*p == '\n'));
+    int adv = (end) ? 0 : text_advance(font, *p);
+
+    // finish the line at the last space or, if none, before this char
+    while (end || ((line_w + adv > w) && (p > line)))
+    {
+      const char *stop = (end || (brk == NULL)) ? p : brk;
+
+      tft.setCursor(x, y);
+      tft.write((const uint8_t *) line, stop - line);
+      y += font->yAdvance;
+      if (++lines == max_lines)
+        return lines;
+
+      if (end)
+        break;
+
+      if (stop == brk)
+      {
+        line_w -= brk_w + text_advance(font, ' ');
+        line = brk + 1;
+      }
+      else
+      {
+        line_w = 0;
+        line = p;
+      }
+      brk = NULL;
+    }
+
+    if (*p == '\0')
+      return lines;
+
+    if (*p == '\n')
+    {
+      line = p + 1;
+      line_w = 0;
+      brk = NULL;
+      continue;
+    }
+
+    if (*p == ' ')
+    {
+      brk = p;
+      brk_w = line_w;
+    }
+    line_w += adv;
+  }
+}
@@ -0,0 +1,27 @@
+#ifndef TEXT_H
+#define TEXT_H
+
+////////////////////////////////////////////////////////////////////////////////
+// Text measurement and layout for PixelVFO.
+//
+// Widths come straight from the xAdvance values in a font's glyph table,
+// so a string is measured in one pass without drawing anything.  Wrapped
+// text is laid out in one pass too, and the string is never modified.
+//
+// text_label_width() caches widths by string address, so it must only be
+// given labels whose text doesn't change.  A buffer that is rewritten
+// must be passed to text_forget() after each change.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+
+#define TEXT_CACHE_SIZE     32      // number of cached label widths, power of 2
+
+int text_width(const GFXfont *font, const char *str, int len);
+int text_label_width(const GFXfont *font, const char *label);
+void text_forget(const char *label);
+int text_draw_wrapped(const GFXfont *font, const char *str,
+                      int x, int y, int w, int max_lines);
+
+#endif
@@ -0,0 +1,149 @@
+#!/usr/bin/env python3
+"""
+Back up or restore the whole PixelVFO EEPROM over the CAT serial port.
+
+Usage: eeprom_backup.py [-r | -w] <serial port> <image file>
+
+With -r (the default) the EEPROM image is read from the VFO and written
+to <image file>.  With -w the image in <image file> is sent to the VFO and
+written to its EEPROM.  The image holds the slots, calibration, VFO state
+and markers, see backup.h for the frame format.  A restored image only
+suits firmware with the same EEPROM layout, the VFO refuses an image of
+the wrong size.  Needs the 'pyserial' package.
+"""
+
+import getopt
+import re
+import sys
+import time
+
+import serial
+
+CHUNK = 16          # must match BACKUP_CHUNK in backup.h
+RETRIES = 3         # times a frame is sent before giving up
+
+
+def usage(msg=None):
+    if msg:
+        print(f'*****\n* {msg}\n*****')
+    print(__doc__)
+    sys.exit(2)
+
+
+def crc16(data, crc=0xFFFF):
+    """CRC-16/CCITT, as backup_crc() in backup.cpp."""
+
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def frame_crc(offset, data):
+    return crc16(data, crc16(bytes([offset >> 8, offset & 0xFF])))
+
+
+def command(port, cmd, pattern):
+    """Send a CAT command, return the match of the reply or None on '?;'."""
+
+    for _ in range(RETRIES):
+        port.write(cmd.encode())
+        buff = b''
+        while True:
+            data = port.read(1)
+            if not data:
+                break           # timeout, send again
+            buff += data
+            if buff.endswith(b'?;'):
+                return None
+            m = re.search(pattern, buff)
+            if m:
+                return m
+    raise RuntimeError(f'no reply to {cmd}')
+
+
+def read_image(port):
+    m = command(port, 'ZR;', rb'ZR([0-9A-F]{4}),([0-9A-F]{4});')
+    if not m:
+        raise RuntimeError('VFO refused ZR;')
+    (size, crc) = (int(m.group(1), 16), int(m.group(2), 16))
+
+    image = b''
+    while len(image) < size:
+        offset = len(image)
+        for _ in range(RETRIES):
+            m = command(port, f'ZR{offset:04X};',
+                        rb'ZR%04X((?:[0-9A-F]{2})+)([0-9A-F]{4});' % offset)
+            if m:
+                data = bytes.fromhex(m.group(1).decode())
+                if frame_crc(offset, data) == int(m.group(2), 16):
+                    break
+        else:
+            raise RuntimeError(f'bad frame at offset {offset}')
+        image += data
+
+    if crc16(image) != crc:
+        raise RuntimeError('image CRC is wrong, EEPROM changed while reading?')
+    return image
+
+
+def write_image(port, image):
+    size = len(image)
+    if not command(port, f'ZW{size:04X},{crc16(image):04X};', rb'ZW0000;'):
+        raise RuntimeError('VFO refused the image, wrong size for this firmware?')
+
+    for offset in range(0, size, CHUNK):
+        data = image[offset:offset + CHUNK]
+        cmd = f'ZW{offset:04X}{data.hex().upper()}{frame_crc(offset, data):04X};'
+        for _ in range(RETRIES):
+            if command(port, cmd, rb'ZW%04X;' % (offset + len(data))):
+                break
+        else:
+            raise RuntimeError(f'frame at offset {offset} refused')
+
+    m = command(port, 'ZC;', rb'ZC([0-9A-F]{4});')
+    if not m:
+        raise RuntimeError('VFO refused to write the image')
+    return int(m.group(1), 16)
+
+
+def main(argv):
+    write = False
+
+    try:
+        (opts, args) = getopt.getopt(argv, 'hrw')
+    except getopt.GetoptError as e:
+        usage(str(e))
+    for (opt, arg) in opts:
+        if opt == '-h':
+            usage()
+        elif opt == '-r':
+            write = False
+        elif opt == '-w':
+            write = True
+    if len(args) != 2:
+        usage()
+
+    port = serial.Serial(args[0], 115200, timeout=1)
+    port.write(b'ZM0;')         # the screen mirror shares the port
+    time.sleep(0.5)
+    port.reset_input_buffer()
+
+    if write:
+        with open(args[1], 'rb') as f:
+            image = f.read()
+        words = write_image(port, image)
+        print(f'{len(image)} bytes sent, {words} words written')
+    else:
+        image = read_image(port)
+        with open(args[1], 'wb') as f:
+            f.write(image)
+        print(f'{len(image)} bytes read')
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
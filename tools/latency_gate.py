@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+"""
+Pass/fail gate on the PixelVFO touch-to-photon latency histograms.
+
+Usage: latency_gate.py [-l <limit ms>] [-p <percent>] [-c] <serial port>
+
+Sends the "ZL;" CAT command and checks that, for every screen with
+touches, at least <percent> of touches (default 95) finished drawing
+within <limit ms> (default 50).  A touch only counts as inside the limit
+if its whole histogram bucket is.  Prints the histograms and exits with
+status 1 if any screen fails.  With -c the histograms are cleared after
+reading.  See latency.h for the reply format.  Needs the 'pyserial' package.
+"""
+
+import getopt
+import re
+import sys
+
+import serial
+
+# must match LAT_BUCKET_LIMITS in latency.h (microseconds)
+LIMITS = [1000, 2000, 5000, 10000, 20000, 50000, 100000, 200000, 500000]
+SCREENS = ['main', 'keypad', 'menu', 'dialog']
+
+
+def usage(msg=None):
+    if msg:
+        print(f'*****\n* {msg}\n*****')
+    print(__doc__)
+    sys.exit(2)
+
+
+def read_histograms(port):
+    """Return {screen: (counts, max)} read from the VFO."""
+
+    port.reset_input_buffer()
+    port.write(b'ZL;')
+    result = {}
+    buff = b''
+    while len(result) < len(SCREENS):
+        data = port.read(64)
+        if not data:
+            raise RuntimeError('no reply to ZL;')
+        buff += data
+        for m in re.finditer(rb'ZL(\d)((?:,\d+)+);', buff):
+            values = [int(v) for v in m.group(2).split(b',')[1:]]
+            result[int(m.group(1))] = (values[:-1], values[-1])
+    return result
+
+
+def gate(counts, limit_us, percent):
+    total = sum(counts)
+    inside = sum(c for (c, lim) in zip(counts, LIMITS) if lim <= limit_us)
+    return inside * 100 >= total * percent
+
+
+def main(argv):
+    limit = 50
+    percent = 95
+    clear = False
+
+    try:
+        (opts, args) = getopt.getopt(argv, 'chl:p:')
+    except getopt.GetoptError as e:
+        usage(str(e))
+    for (opt, arg) in opts:
+        if opt == '-c':
+            clear = True
+        elif opt == '-h':
+            usage()
+        elif opt == '-l':
+            limit = float(arg)
+        elif opt == '-p':
+            percent = int(arg)
+    if len(args) != 1:
+        usage()
+
+    port = serial.Serial(args[0], 115200, timeout=2)
+    hists = read_histograms(port)
+    if clear:
+        port.write(b'ZL0;')
+
+    ok = True
+    for (screen, (counts, worst)) in sorted(hists.items()):
+        name = SCREENS[screen]
+        if sum(counts) == 0:
+            print(f'{name:8s} no touches')
+            continue
+        passed = gate(counts, limit * 1000, percent)
+        ok = ok and passed
+        print(f'{name:8s} {" ".join(f"{c:5d}" for c in counts)}  '
+              f'max {worst / 1000:.1f}ms  {"PASS" if passed else "FAIL"}')
+
+    return 0 if ok else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
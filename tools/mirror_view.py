@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+"""
+A viewer for the PixelVFO screen mirror stream.
+
+Usage: mirror_view.py <serial port>
+
+Sends the "ZM1;" CAT command to start mirroring, then rebuilds the VFO
+screen from the stream and shows it in a window.  See mirror.h for the
+stream format.  Needs the 'pyserial' package.
+"""
+
+import struct
+import sys
+import threading
+import tkinter
+
+import serial
+
+SYNC = b'\xa5\x5a'
+SKIP = 0x8000
+
+
+class Screen:
+    """The rebuilt screen, RGB565 pixels in a flat list."""
+
+    def __init__(self, width=320, height=240):
+        self.resize(width, height)
+        self.lock = threading.Lock()
+        self.dirty = True
+
+    def resize(self, width, height):
+        self.width = width
+        self.height = height
+        self.pixels = [0] * (width * height)
+
+    def rect(self, x, y, w, h, runs):
+        """Apply a rectangle of runs, each (count, color or None)."""
+
+        with self.lock:
+            ndx = 0
+            for (count, color) in runs:
+                for _ in range(count):
+                    if color is not None:
+                        px = x + ndx % w
+                        py = y + ndx // w
+                        if px < self.width and py < self.height:
+                            self.pixels[py * self.width + px] = color
+                    ndx += 1
+            self.dirty = True
+
+    def image_data(self):
+        """Return the screen as PhotoImage 'put' data."""
+
+        with self.lock:
+            self.dirty = False
+            rows = []
+            for y in range(self.height):
+                row = self.pixels[y * self.width:(y + 1) * self.width]
+                rows.append('{' + ' '.join('#%02x%02x%02x' % rgb(c) for c in row) + '}')
+            return ' '.join(rows)
+
+
+def rgb(color):
+    """Convert RGB565 to an (r, g, b) tuple."""
+
+    return (((color >> 11) & 0x1f) << 3, ((color >> 5) & 0x3f) << 2, (color & 0x1f) << 3)
+
+
+def reader(port, screen):
+    """Read and decode the mirror stream forever."""
+
+    def read(num):
+        data = b''
+        while len(data) < num:
+            data += port.read(num - len(data))
+        return data
+
+    while True:
+        # find the sync bytes, anything else on the port is ignored
+        if read(1) != SYNC[:1] or read(1) != SYNC[1:]:
+            continue
+
+        kind = read(1)
+        if kind == b'F':
+            (w, h) = struct.unpack('<HH', read(4))
+            with screen.lock:
+                screen.resize(w, h)
+        elif kind == b'R':
+            (x, y, w, h) = struct.unpack('<HHHH', read(8))
+            runs = []
+            remaining = w * h
+            while remaining > 0:
+                (count,) = struct.unpack('<H', read(2))
+                if count & SKIP:
+                    count &= ~SKIP
+                    runs.append((count, None))
+                else:
+                    (color,) = struct.unpack('<H', read(2))
+                    runs.append((count, color))
+                remaining -= count
+            screen.rect(x, y, w, h, runs)
+
+
+def main():
+    if len(sys.argv) != 2:
+        print(__doc__)
+        return 1
+
+    port = serial.Serial(sys.argv[1], 115200)
+    port.write(b'ZM1;')
+
+    screen = Screen()
+    threading.Thread(target=reader, args=(port, screen), daemon=True).start()
+
+    root = tkinter.Tk()
+    root.title('PixelVFO mirror')
+    image = tkinter.PhotoImage(width=screen.width, height=screen.height)
+    tkinter.Label(root, image=image).pack()
+
+    def refresh():
+        if screen.dirty:
+            if image.width() != screen.width or image.height() != screen.height:
+                image.configure(width=screen.width, height=screen.height)
+            image.put(screen.image_data())
+        root.after(100, refresh)
+
+    refresh()
+    root.mainloop()
+
+    port.write(b'ZM0;')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
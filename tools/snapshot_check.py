@@ -0,0 +1,293 @@
+#!/usr/bin/env python3
+"""
+Pixel-exact check of every PixelVFO screen against saved images.
+
+Usage: snapshot_check.py [-u] [-j <jobs>] [-o <dir>] <serial port> [<image dir>]
+
+Has the VFO draw each snapshot scenario (main screen, keypad, menus,
+dialogs, credits, abort) into the screen mirror stream, see snapshot.h.
+Each scenario's part of the stream is rebuilt into a screen of its own and
+compared with <image dir>/<name>.ppm, in <jobs> processes (default, one
+per CPU).  The default <image dir> is the committed reference for the
+screen size, tools/snapshots/<width>x<height>.
+
+Prints a line for each scenario and exits with status 1 if any screen
+differs.  The screen drawn is written to <dir> (default 'snapshot_out')
+for each failure, with a '-diff' image showing the differing pixels in
+red.  A scenario with no saved image, such as a new menu, fails, and its
+screen is written to <dir> to be checked by eye.  With -u all the drawn
+screens are saved as the new reference, to be committed.  Needs the
+'pyserial' package.
+"""
+
+import array
+import getopt
+import multiprocessing
+import os
+import re
+import struct
+import sys
+import time
+
+import serial
+
+SYNC = b'\xa5\x5a'
+SKIP = 0x8000
+RETRIES = 3         # times a scenario is asked for before giving up
+REFERENCE = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'snapshots')
+
+
+def usage(msg=None):
+    if msg:
+        print(f'*****\n* {msg}\n*****')
+    print(__doc__)
+    sys.exit(2)
+
+
+class Capture:
+    """Reads the mirror stream, keeping the messages since the last marker."""
+
+    def __init__(self, port):
+        self.port = port
+        self.size = None        # (width, height) from the last full frame
+        self.stream = bytearray()
+
+    def read(self, num):
+        data = self.port.read(num)
+        if len(data) < num:
+            raise TimeoutError
+        return data
+
+    def message(self):
+        """Read one message, return its kind and for a marker (id, name)."""
+
+        # find the sync bytes, anything else on the port is ignored
+        while self.read(1) != SYNC[:1] or self.read(1) != SYNC[1:]:
+            pass
+
+        kind = self.read(1)
+        if kind == b'F':
+            self.size = struct.unpack('<HH', self.read(4))
+            self.stream = bytearray()
+        elif kind == b'R':
+            msg = SYNC + kind + self.read(8)
+            (w, h) = struct.unpack('<HH', msg[7:11])
+            remaining = w * h
+            while remaining > 0:
+                run = self.read(2)
+                (count,) = struct.unpack('<H', run)
+                if not count & SKIP:
+                    run += self.read(2)
+                msg += run
+                remaining -= count & ~SKIP
+            self.stream += msg
+        elif kind == b'M':
+            (num, length) = struct.unpack('<HB', self.read(3))
+            return (kind, (num, self.read(length).decode(errors='replace')))
+        return (kind, None)
+
+    def snapshot(self, num):
+        """Draw scenario 'num', return its name and stream."""
+
+        for _ in range(RETRIES):
+            self.port.write(f'ZT{num:03d};'.encode())
+            self.stream = bytearray()
+            try:
+                while True:
+                    (kind, marker) = self.message()
+                    if kind == b'M':
+                        if marker[0] == num:
+                            return (marker[1], bytes(self.stream))
+                        self.stream = bytearray()   # left from a retry
+            except TimeoutError:
+                pass
+        raise RuntimeError(f'no snapshot {num} from the VFO')
+
+
+def capture(port):
+    """Return the screen size and [(name, stream)] of every scenario."""
+
+    port.write(b'ZM0;')         # the mirror shares the port with CAT replies
+    time.sleep(0.5)
+    port.reset_input_buffer()
+    port.write(b'ZT;')
+    buff = b''
+    while True:
+        data = port.read(1)
+        if not data:
+            raise RuntimeError('no reply to ZT;')
+        buff += data
+        m = re.search(rb'ZT(\d{3});', buff)
+        if m:
+            break
+    count = int(m.group(1))
+
+    cap = Capture(port)
+    port.write(b'ZM1;')
+    try:
+        while cap.size is None:
+            cap.message()
+    except TimeoutError:
+        raise RuntimeError('no mirror stream from the VFO')
+
+    scenarios = [cap.snapshot(num) for num in range(count)]
+    port.write(b'ZM0;')
+    return (cap.size, scenarios)
+
+
+def render(stream, width, height):
+    """Rebuild a screen from rectangle messages, return RGB565 pixels."""
+
+    pixels = array.array('H', bytes(width * height * 2))
+    pos = 0
+    while pos < len(stream):
+        (x, y, w, h) = struct.unpack_from('<HHHH', stream, pos + 3)
+        pos += 11
+        ndx = 0
+        while ndx < w * h:
+            (count,) = struct.unpack_from('<H', stream, pos)
+            pos += 2
+            color = None
+            if count & SKIP:
+                count &= ~SKIP
+            else:
+                (color,) = struct.unpack_from('<H', stream, pos)
+                pos += 2
+            while count > 0:
+                (row, col) = divmod(ndx, w)
+                span = min(count, w - col)
+                (px, py) = (x + col, y + row)
+                end = min(px + span, width)
+                if color is not None and py < height and px < end:
+                    base = py * width
+                    pixels[base + px:base + end] = array.array('H', [color]) * (end - px)
+                ndx += span
+                count -= span
+    return pixels
+
+
+RGB = None          # RGB565 to RGB bytes, built once in each process
+
+
+def ppm(pixels, width, height):
+    global RGB
+    if RGB is None:
+        RGB = [bytes((((c >> 11) & 0x1f) << 3, ((c >> 5) & 0x3f) << 2, (c & 0x1f) << 3))
+               for c in range(0x10000)]
+    return f'P6 {width} {height} 255\n'.encode() + b''.join(RGB[c] for c in pixels)
+
+
+def compare(image, golden, width):
+    """Return the number of differing pixels, their bounds and a diff image."""
+
+    header = image[:image.index(b'\n') + 1]
+    (a, b) = (image[len(header):], golden[len(header):])
+    diff = bytearray(len(a))
+    (count, x1, y1, x2, y2) = (0, width, 1 << 16, -1, -1)
+    for i in range(0, len(a), 3):
+        if a[i:i + 3] == b[i:i + 3]:
+            diff[i:i + 3] = bytes(c // 4 for c in a[i:i + 3])
+        else:
+            diff[i:i + 3] = b'\xff\x00\x00'
+            (y, x) = divmod(i // 3, width)
+            (count, x1, y1, x2, y2) = (count + 1, min(x1, x), min(y1, y), max(x2, x), max(y2, y))
+    return (count, (x1, y1, x2, y2), header + bytes(diff))
+
+
+def check(job):
+    """Rebuild one scenario's screen and check or save it."""
+
+    (name, stream, (width, height), image_dir, out_dir, update) = job
+    image = ppm(render(stream, width, height), width, height)
+    path = os.path.join(image_dir, name + '.ppm')
+
+    if update:
+        with open(path, 'wb') as f:
+            f.write(image)
+        return 'saved'
+
+    golden = None
+    if os.path.exists(path):
+        with open(path, 'rb') as f:
+            golden = f.read()
+    if golden == image:
+        return 'PASS'
+    diff = None
+    if golden is None:
+        result = 'FAIL, no saved image, check the screen drawn and save it with -u'
+    elif len(golden) != len(image):
+        result = 'FAIL, saved image is a different size'
+    else:
+        (count, bounds, diff) = compare(image, golden, width)
+        result = f'FAIL, {count} pixels differ in ({bounds[0]},{bounds[1]})-({bounds[2]},{bounds[3]})'
+
+    os.makedirs(out_dir, exist_ok=True)
+    with open(os.path.join(out_dir, name + '.ppm'), 'wb') as f:
+        f.write(image)
+    if diff:
+        with open(os.path.join(out_dir, name + '-diff.ppm'), 'wb') as f:
+            f.write(diff)
+    return result
+
+
+def file_names(names):
+    """Make scenario names safe and unique as file names."""
+
+    result = []
+    for name in names:
+        name = re.sub(r'[^\w-]', '_', name)
+        unique = name
+        n = 2
+        while unique in result:
+            unique = f'{name}-{n}'
+            n += 1
+        result.append(unique)
+    return result
+
+
+def main(argv):
+    update = False
+    jobs = os.cpu_count()
+    out_dir = 'snapshot_out'
+
+    try:
+        (opts, args) = getopt.getopt(argv, 'hj:o:u')
+    except getopt.GetoptError as e:
+        usage(str(e))
+    for (opt, arg) in opts:
+        if opt == '-h':
+            usage()
+        elif opt == '-j':
+            jobs = int(arg)
+        elif opt == '-o':
+            out_dir = arg
+        elif opt == '-u':
+            update = True
+    if len(args) not in (1, 2):
+        usage()
+
+    start = time.time()
+    port = serial.Serial(args[0], 115200, timeout=2)
+    (size, scenarios) = capture(port)
+    captured = time.time()
+
+    image_dir = args[1] if len(args) > 1 else os.path.join(REFERENCE, f'{size[0]}x{size[1]}')
+    os.makedirs(image_dir, exist_ok=True)
+    names = file_names(name for (name, _) in scenarios)
+    work = [(name, stream, size, image_dir, out_dir, update)
+            for (name, (_, stream)) in zip(names, scenarios)]
+    with multiprocessing.Pool(jobs) as pool:
+        results = pool.map(check, work)
+
+    ok = True
+    for (name, result) in zip(names, results):
+        ok = ok and not result.startswith('FAIL')
+        print(f'{name:24s} {result}')
+    print(f'{len(names)} screens, captured in {captured - start:.1f}s, '
+          f'checked in {time.time() - captured:.1f}s')
+
+    return 0 if ok else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
@@ -7,6 +7,9 @@
 #include "PixelVFO.h"
 #include "hotspot.h"
 #include "utils.h"
+#include "profile.h"
+#include "text.h"
+#include "overlay.h"
 
 
 #define BUTTON_RADIUS   5
@@ -44,13 +47,9 @@
 void util_button(const char *title, int x, int y, int w, int h,
                  uint16_t bg1, uint16_t bg2, uint16_t fg)
 {
-  int16_t x1;   // used to get extent of title text
-  int16_t y1;
-  uint16_t w1;
-  uint16_t h1;
+  PROFILE_ZONE(PZ_UtilButton);
 
   // draw button background
-  tft.drawRoundRect(x, y, w, h, BUTTON_RADIUS, bg1);
   tft.fillRoundRect(x, y, w, h, BUTTON_RADIUS, bg1);
 
   tft.fillRoundRect(x+1, y+1, w-2, h-2, BUTTON_RADIUS, bg2);
@@ -58,8 +57,7 @@ void util_button(const char *title, int x, int y, int w, int h,
   tft.setTextColor(fg);
   
   // figure out where to draw centred title
-  tft.getTextBounds((char *) title, 1, 1, &x1, &y1, &w1, &h1);
-  tft.setCursor(x + (w - w1)/2, y+25);
+  tft.setCursor(x + (w - text_label_width(FONT_BUTTON, title))/2, y+25);
   tft.print(title);
 }
 
@@ -100,21 +98,23 @@ HotSpot hs_dlg_confirm[] =
 //----------------------------------------
 // Draw a single button ALERT dialog box.
 //     msg  address of message string
-// Used by draw_confirm().
+// Used by draw_confirm().  The screen beneath is put back by overlay_close().
 //----------------------------------------
 
-static void draw_alert(const char *msg)
+void draw_alert(const char *msg)
 {
+  overlay_open();
+  overlay_cover(ALERT_X, ALERT_Y, ALERT_W, ALERT_H);
+
   // draw dialog body
   tft.drawRoundRect(ALERT_X, ALERT_Y, ALERT_W, ALERT_H, CORNER_RADIUS, DLG_BG);
   tft.drawRoundRect(ALERT_X+1, ALERT_Y+1, ALERT_W-2, ALERT_H-2, CORNER_RADIUS, DLG_BG);
   tft.fillRoundRect(ALERT_X+2, ALERT_Y+2, ALERT_W-4, ALERT_H-4, CORNER_RADIUS, DLG_BG2);
   
-  // draw text (centred)
-  tft.setCursor(ALERT_X + 7, ALERT_Y + 25);
-  tft.setFont(FONT_DIALOG);
+  // draw text, wrapped to fit above the buttons
   tft.setTextColor(DLG_FG);
-  tft.print(msg);
+  text_draw_wrapped(FONT_DIALOG, msg, ALERT_X + 7, ALERT_Y + 25, ALERT_W - 14,
+                    (ALERT_H - OK_HEIGHT - 25) / FONT_DIALOG->yAdvance);
 
   // draw the "OK" button
   util_button("Ok",
@@ -125,6 +125,7 @@ static void draw_alert(const char *msg)
 //----------------------------------------
 // Draw a single button ALERT dialog box, wait for click.
 //     msg  address of message string
+// The screen beneath is restored if it registered its widgets, see overlay.h.
 //----------------------------------------
 
 void util_alert(const char *msg)
@@ -138,11 +139,13 @@ void util_alert(const char *msg)
     int x;          // pen touch coordinates
     int y;
 
-    if (pen_touch(&x, &y))
+    if (pen_touch(&x, &y, LAT_Dialog))
     {
       if (HotSpot *hs = hs_touched(x, y, hs_dlg_alert, DlgAlertHSLen))
       {
+        hs_press(hs);
         (*hs->handler)(hs);
+        overlay_close();
         DEBUG("alert: returning, OK selected\n");
         return;
       }
@@ -155,7 +158,7 @@ void util_alert(const char *msg)
 //     msg  address of message string
 //----------------------------------------
 
-static void draw_confirm(const char *msg)
+void draw_confirm(const char *msg)
 {
   // draw MOST of the dialog
   draw_alert(msg);
@@ -170,6 +173,7 @@ static void draw_confirm(const char *msg)
 // Draw a two button CONFIRM dialog box, wait for click.
 //     msg  address of message string
 // Returns 'true' if 'OK' button selected, else 'false'.
+// The screen beneath is restored if it registered its widgets, see overlay.h.
 //----------------------------------------
 
 bool util_confirm(const char *msg)
@@ -184,11 +188,13 @@ bool util_confirm(const char *msg)
     int x;            // pen touch coordinates
     int y;
 
-    if (pen_touch(&x, &y))
+    if (pen_touch(&x, &y, LAT_Dialog))
     {
       if (HotSpot *hs = hs_touched(x, y, hs_dlg_confirm, DlgConfirmHSLen))
       {
+        hs_press(hs);
         bool result = (*hs->handler)(hs);
+        overlay_close();
         DEBUG("confirm: returning, %s selected, returning %s\n",
               (result) ? "OK" : "Cancel", (result) ? "true" : "false");
         return result;